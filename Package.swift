@@ -34,6 +34,14 @@ let platformTargets: [Target] = [
     .target(
         name: "SVGRenderer",
         dependencies: ["SwiftPlot"]),
+
+    // Benchmarks.
+    .target(
+        name: "AGGBatchBenchmark",
+        dependencies: ["AGGRenderer", "SwiftPlot"]),
+    .target(
+        name: "AGGBlendBenchmark",
+        dependencies: ["CPPAGGRenderer"]),
     
     .testTarget(
       name: "SwiftPlotTests",
@@ -81,6 +89,14 @@ let platformTargets: [Target] = [
     .target(
         name: "QuartzRenderer",
         dependencies: ["SwiftPlot"]),
+
+    // Benchmarks.
+    .target(
+        name: "AGGBatchBenchmark",
+        dependencies: ["AGGRenderer", "SwiftPlot"]),
+    .target(
+        name: "AGGBlendBenchmark",
+        dependencies: ["CPPAGGRenderer"]),
     
     .testTarget(
       name: "SwiftPlotTests",
@@ -0,0 +1,70 @@
+import Foundation
+import SwiftPlot
+import AGGRenderer
+
+// Renders a batch of mixed charts with AGGBatchRenderer and reports the throughput.
+//
+// Usage: swift run -c release AGGBatchBenchmark [chart count] [worker count]
+
+let arguments = CommandLine.arguments
+let chartCount = arguments.count > 1 ? Int(arguments[1]) ?? 10_000 : 10_000
+let workerCount = arguments.count > 2 ? Int(arguments[2]) ?? 0 : ProcessInfo.processInfo.activeProcessorCount
+guard chartCount > 0, workerCount > 0 else {
+    print("Usage: AGGBatchBenchmark [chart count] [worker count]")
+    exit(1)
+}
+
+/// Returns one of four kinds of chart, with data varying by `index`.
+func makeChart(_ index: Int) -> Plot {
+    let phase = Float(index % 97) / 10
+    switch index % 4 {
+    case 0:
+        let x = (0..<200).map { Float($0) }
+        var lineGraph = LineGraph<Float,Float>(enablePrimaryAxisGrid: true)
+        lineGraph.addSeries(x, x.map { sin($0 / 20 + phase) * 100 }, label: "sin", color: .lightBlue)
+        lineGraph.addSeries(x, x.map { cos($0 / 20 + phase) * 80 }, label: "cos", color: .orange)
+        lineGraph.plotTitle = PlotTitle("LINE CHART \(index)")
+        lineGraph.plotLabel = PlotLabel(xLabel: "X-AXIS", yLabel: "Y-AXIS")
+        return lineGraph
+    case 1:
+        let x = ["2016", "2017", "2018", "2019", "2020", "2021"]
+        var barGraph = BarGraph<String,Float>(enableGrid: true)
+        barGraph.addSeries(x, x.indices.map { Float($0 * 40) + phase * 10 }, label: "Plot 1", color: .orange)
+        barGraph.plotTitle = PlotTitle("BAR CHART \(index)")
+        barGraph.plotLabel = PlotLabel(xLabel: "X-AXIS", yLabel: "Y-AXIS")
+        return barGraph
+    case 2:
+        let x = (0..<300).map { Float($0) / 3 }
+        var scatterPlot = ScatterPlot<Float,Float>(enableGrid: true)
+        scatterPlot.addSeries(x, x.map { $0 * sin($0 + phase) }, label: "Plot 1", color: .green, scatterPattern: .circle)
+        scatterPlot.plotTitle = PlotTitle("SCATTER PLOT \(index)")
+        scatterPlot.plotLabel = PlotLabel(xLabel: "X-AXIS", yLabel: "Y-AXIS")
+        return scatterPlot
+    default:
+        let values = (0..<1000).map { sin(Float($0) * 0.37 + phase) * Float($0 % 50) }
+        var histogram = Histogram<Float>(isNormalized: false, enableGrid: true)
+        histogram.addSeries(data: values, bins: 40, label: "Plot 1", color: .blue)
+        histogram.plotTitle = PlotTitle("HISTOGRAM \(index)")
+        histogram.plotLabel = PlotLabel(xLabel: "X-AXIS", yLabel: "FREQUENCY")
+        return histogram
+    }
+}
+
+let jobs = (0..<chartCount).map {
+    AGGBatchRenderer.Job(plot: makeChart($0), size: Size(width: 800, height: 600))
+}
+let batchRenderer = AGGBatchRenderer(workerCount: workerCount)
+var totalBytes = 0
+let bytesLock = NSLock()
+let report = batchRenderer.render(jobs) { _, result in
+    if case .success(let data) = result {
+        bytesLock.lock()
+        totalBytes += data.count
+        bytesLock.unlock()
+    }
+}
+
+print("Rendered \(report.chartCount) charts (\(report.failureCount) failed) on \(report.workerCount) workers")
+print(String(format: "Elapsed: %.2f s, PNG output: %.1f MiB", report.elapsedTime, Double(totalBytes) / 1_048_576))
+print(String(format: "Throughput: %.1f charts/sec, %.1f charts/sec per core",
+             report.chartsPerSecond, report.chartsPerSecondPerWorker))
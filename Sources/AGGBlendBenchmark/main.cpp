@@ -0,0 +1,112 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "span_blend.h"
+
+// Times the span blend kernels of each implementation this CPU supports, over spans of
+// varying widths and coverage, and checks that each produces exactly the scalar result.
+//
+// Usage: swift run -c release AGGBlendBenchmark [iterations]
+
+namespace {
+
+  enum coverage_kind { full_coverage, partial_coverage, edge_coverage };
+
+  const char* coverage_name(coverage_kind kind){
+    switch (kind) {
+      case full_coverage: return "full";
+      case partial_coverage: return "partial";
+      default: return "edges";
+    }
+  }
+
+  // Covers as a scanline renderer produces them: all full, all random, or full with
+  // anti-aliased ends.
+  std::vector<agg::int8u> make_covers(unsigned len, coverage_kind kind){
+    std::vector<agg::int8u> covers(len, 255);
+    for (unsigned i = 0; i < len; i++) {
+      if (kind == partial_coverage || (kind == edge_coverage && (i < 2 || i + 2 >= len)))
+        covers[i] = agg::int8u(rand());
+    }
+    return covers;
+  }
+
+  // Runs every kernel over the same random row with the given implementation.
+  std::vector<agg::int8u> run_kernels(span_blend::implementation impl, const std::vector<agg::int8u>& row,
+                                      const std::vector<agg::int8u>& covers, const agg::int8u* rgb, agg::int8u alpha){
+    span_blend::set_implementation(impl);
+    std::vector<agg::int8u> result(row);
+    unsigned len = unsigned(covers.size());
+    span_blend::blend_solid_span(result.data(), len, rgb, alpha, covers.data());
+    span_blend::blend_hline(result.data(), len, rgb, alpha);
+    span_blend::fill_hline(result.data() + 3 * (len / 2), len - len / 2, rgb);
+    return result;
+  }
+
+  bool results_match(span_blend::implementation impl){
+    for (int trial = 0; trial < 2000; trial++) {
+      unsigned len = 1 + rand() % 200;
+      std::vector<agg::int8u> row(3 * len);
+      for (size_t i = 0; i < row.size(); i++) row[i] = agg::int8u(rand());
+      std::vector<agg::int8u> covers = make_covers(len, coverage_kind(trial % 3));
+      agg::int8u rgb[3] = { agg::int8u(rand()), agg::int8u(rand()), agg::int8u(rand()) };
+      agg::int8u alpha = agg::int8u(rand());
+      if (run_kernels(impl, row, covers, rgb, alpha) != run_kernels(span_blend::scalar, row, covers, rgb, alpha))
+        return false;
+    }
+    return true;
+  }
+
+  // Returns the time taken to blend a span of len pixels, in nanoseconds.
+  double time_span(unsigned len, coverage_kind kind, int iterations){
+    const unsigned rows = 64;
+    std::vector<agg::int8u> image(3 * len * rows, 200);
+    std::vector<agg::int8u> covers = make_covers(len, kind);
+    const agg::int8u rgb[3] = { 30, 120, 220 };
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      agg::int8u* row = image.data() + 3 * len * (i % rows);
+      if (kind == full_coverage)
+        span_blend::blend_hline(row, len, rgb, 180);
+      else
+        span_blend::blend_solid_span(row, len, rgb, 180, covers.data());
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+  }
+
+}
+
+int main(int argc, char** argv){
+  int iterations = argc > 1 ? atoi(argv[1]) : 200000;
+  if (iterations <= 0) {
+    printf("Usage: AGGBlendBenchmark [iterations]\n");
+    return 1;
+  }
+  const span_blend::implementation all[] = { span_blend::scalar, span_blend::sse2, span_blend::avx2, span_blend::neon };
+  const unsigned widths[] = { 4, 16, 64, 256, 1024 };
+  const coverage_kind kinds[] = { full_coverage, partial_coverage, edge_coverage };
+  bool all_match = true;
+
+  printf("%-8s %-8s", "impl", "covers");
+  for (unsigned width : widths) printf(" %9u px", width);
+  printf("   (ns per span)\n");
+  for (span_blend::implementation impl : all) {
+    if (!span_blend::set_implementation(impl))
+      continue;
+    if (!results_match(impl)) {
+      printf("%s: results differ from the scalar kernels\n", span_blend::implementation_name(impl));
+      all_match = false;
+      continue;
+    }
+    span_blend::set_implementation(impl);
+    for (coverage_kind kind : kinds) {
+      printf("%-8s %-8s", span_blend::implementation_name(impl), coverage_name(kind));
+      for (unsigned width : widths) printf(" %12.1f", time_span(width, kind, iterations));
+      printf("\n");
+    }
+  }
+  return all_match ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+import Foundation
+import SwiftPlot
+
+/// Renders batches of plots to PNG images on a fixed number of worker threads.
+///
+/// Each worker keeps its own `AGGRenderer` for as long as the batch renderer lives. Between
+/// jobs the renderer's image is cleared and resized if needed, but its fonts, glyphs and
+/// measured text are kept, so after the first few charts text is drawn warm.
+///
+/// Batches are rendered one at a time; concurrent calls to `render` wait for each other.
+public final class AGGBatchRenderer {
+
+    /// Where a job's PNG image is written, in addition to being passed to the callback.
+    public enum Output {
+        /// The image is only kept in memory.
+        case memory
+        /// The image is also written to the given file.
+        case file(URL)
+    }
+
+    public struct Job {
+        public var plot: Plot
+        public var size: Size
+        public var output: Output
+
+        public init(plot: Plot, size: Size = Size(width: 1000, height: 660), output: Output = .memory) {
+            self.plot = plot
+            self.size = size
+            self.output = output
+        }
+    }
+
+    /// Aggregate throughput of a batch.
+    public struct Report {
+        public var chartCount: Int
+        public var failureCount: Int
+        public var workerCount: Int
+        /// The wall-clock time taken to render the batch, in seconds.
+        public var elapsedTime: Double
+
+        public var chartsPerSecond: Double {
+            return elapsedTime > 0 ? Double(chartCount) / elapsedTime : 0
+        }
+
+        public var chartsPerSecondPerWorker: Double {
+            return workerCount > 0 ? chartsPerSecond / Double(workerCount) : 0
+        }
+    }
+
+    public let workerCount: Int
+    public let fontPath: String
+    /// Whether the workers' renderers draw text from their glyph atlases.
+    /// See `AGGRenderer.usesGlyphAtlas`.
+    public let usesGlyphAtlas: Bool
+    /// The quality the workers' renderers draw at. See `AGGRenderer.renderQuality`.
+    public let renderQuality: AGGRenderer.RenderQuality
+
+    private var renderers: [AGGRenderer?]
+    private let batchLock = NSLock()
+
+    public init(workerCount: Int = ProcessInfo.processInfo.activeProcessorCount,
+                fontPath: String = "",
+                usesGlyphAtlas: Bool = false,
+                renderQuality: AGGRenderer.RenderQuality = .normal) {
+        precondition(workerCount > 0, "AGGBatchRenderer: workerCount must be positive.")
+        self.workerCount = workerCount
+        self.fontPath = fontPath
+        self.usesGlyphAtlas = usesGlyphAtlas
+        self.renderQuality = renderQuality
+        self.renderers = [AGGRenderer?](repeating: nil, count: workerCount)
+    }
+
+    /// Renders `jobs`, blocking until all of them are finished.
+    ///
+    /// `onResult` is called with each job's index and its PNG data, or the error which
+    /// stopped it from being rendered. It is called on the worker threads, possibly
+    /// concurrently, and in no particular order.
+    @discardableResult
+    public func render(_ jobs: [Job], onResult: (Int, Result<Data, Error>) -> Void) -> Report {
+        batchLock.lock(); defer { batchLock.unlock() }
+
+        let start = DispatchTime.now().uptimeNanoseconds
+        var nextJob = 0
+        var failureCount = 0
+        let jobLock = NSLock()
+        let workers = min(workerCount, jobs.count)
+
+        // Create the renderers up front, so the workers never touch the shared array.
+        for worker in 0..<workers where renderers[worker] == nil {
+            let renderer = AGGRenderer(fontPath: fontPath)
+            renderer.usesGlyphAtlas = usesGlyphAtlas
+            renderer.renderQuality = renderQuality
+            renderers[worker] = renderer
+        }
+        let workerRenderers = renderers.prefix(workers).map { $0! }
+
+        DispatchQueue.concurrentPerform(iterations: workers) { worker in
+            let renderer = workerRenderers[worker]
+            while true {
+                jobLock.lock()
+                let index = nextJob
+                nextJob += 1
+                jobLock.unlock()
+                guard index < jobs.count else { return }
+
+                let result = Result<Data, Error> {
+                    try AGGBatchRenderer.render(jobs[index], with: renderer)
+                }
+                if case .failure = result {
+                    jobLock.lock()
+                    failureCount += 1
+                    jobLock.unlock()
+                }
+                onResult(index, result)
+            }
+        }
+
+        let elapsed = Double(DispatchTime.now().uptimeNanoseconds - start) / 1e9
+        return Report(chartCount: jobs.count, failureCount: failureCount,
+                      workerCount: workers, elapsedTime: elapsed)
+    }
+
+    /// Renders `jobs`, returning the result of each job in order.
+    public func render(_ jobs: [Job]) -> (results: [Result<Data, Error>], report: Report) {
+        var results = [Result<Data, Error>?](repeating: nil, count: jobs.count)
+        let resultsLock = NSLock()
+        let report = render(jobs) { index, result in
+            resultsLock.lock()
+            results[index] = result
+            resultsLock.unlock()
+        }
+        return (results.map { $0! }, report)
+    }
+
+    private static func render(_ job: Job, with renderer: AGGRenderer) throws -> Data {
+        renderer.offset = .zero
+        renderer.imageSize = job.size
+        job.plot.drawGraph(size: job.size, renderer: renderer)
+        let data = try renderer.pngData()
+        if case .file(let url) = job.output {
+            try data.write(to: url)
+        }
+        return data
+    }
+}
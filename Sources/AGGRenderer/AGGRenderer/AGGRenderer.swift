@@ -2,17 +2,95 @@ import Foundation
 import CAGGRenderer
 import SwiftPlot
 
+/// A renderer which rasterizes plots into an RGB image using Anti-Grain Geometry.
+///
+/// Thread safety: each `AGGRenderer` owns all of its drawing state, including its own
+/// FreeType library and font faces, so different renderers may be used concurrently
+/// from different threads without locking. Font files are read once per process and
+/// shared read-only between renderers. A single renderer must not be used from more
+/// than one thread at a time.
 public class AGGRenderer: Renderer{
 
     public var offset: Point = .zero
     public var imageSize: Size {
         willSet {
-          delete_plot(agg_object);
-          agg_object = initializePlot(newValue.width, newValue.height, fontPath)
+          // Clears the image and the clip rect, keeping the loaded fonts and glyphs.
+          reset_plot(newValue.width, newValue.height, agg_object)
+          frameClipRect = nil
         }
     }
     var agg_object: UnsafeMutableRawPointer
     var fontPath = ""
+    /// The clip rect set with `setClipRect`, in the image's coordinates.
+    private var frameClipRect: Rect?
+
+    /// Whether text is kerned using the font's `kern` table. Defaults to `false`.
+    public var usesKerning = false {
+        didSet {
+            set_text_kerning(usesKerning, agg_object)
+            removeTextRuns()
+        }
+    }
+
+    /// Whether unrotated text is composited straight from an atlas of pre-rasterized glyph
+    /// masks. Glyphs are positioned to a quarter of a pixel, rather than snapped to whole
+    /// pixels, so the output differs slightly. Defaults to `false`.
+    public var usesGlyphAtlas = false {
+        didSet { set_glyph_atlas(usesGlyphAtlas, agg_object) }
+    }
+
+    /// Polylines, such as line graph series, no wider than this are drawn as anti-aliased
+    /// hairlines instead of having their outlines filled. This is much faster for long series,
+    /// but points less than about 1.5 pixels apart are merged and joins are always round,
+    /// so the output differs slightly. Defaults to `0`, which disables hairlines.
+    public var hairlineWidth: Float = 0 {
+        didSet { set_hairline_width(hairlineWidth, agg_object) }
+    }
+
+    /// Whether batches of solid rects, such as the segments of stacked bars, are filled
+    /// in a single pass with AGG's compound rasterizer. Pixels along an edge shared by two
+    /// rects are then split exactly between them, instead of the background showing
+    /// through as a faint seam, so the output differs slightly. This is slower than filling
+    /// the rects one at a time. Defaults to `false`.
+    public var usesCompoundFills = false
+
+    /// Whether layers of a graph which are drawn again unchanged, such as its axes, grid,
+    /// labels and legend, are kept as images and copied into later graphs instead of being
+    /// drawn again, so that a graph redrawn with new data renders no text. Layers are
+    /// clipped to the graph, and are drawn rather than kept while a clip rect cuts through
+    /// them. A layer drawn over the data is kept as what it drew over black and over white,
+    /// and blended from those, which may differ from drawing it by one level in each
+    /// channel. Up to 16 layers are kept. Defaults to `false`.
+    public var cachesLayers = false {
+        didSet { if !cachesLayers { clear_layers(agg_object) } }
+    }
+
+    public enum RenderQuality: Int32 {
+        /// Fills without anti-aliasing, approximates curves coarsely and draws unrotated text
+        /// from hinted glyph bitmaps. Several times faster than `normal`; meant for previews.
+        case draft = 0
+        case normal = 1
+        /// Approximates large circles and ellipses more finely than `normal`.
+        case high = 2
+    }
+
+    /// How carefully shapes and text are rasterized. Text is laid out with hinted glyphs
+    /// in `draft` quality, so it may be measured slightly differently. Defaults to `normal`.
+    public var renderQuality = RenderQuality.normal {
+        didSet {
+            set_render_quality(renderQuality.rawValue, agg_object)
+            removeTextRuns()
+        }
+    }
+
+    /// Text which has been measured, kept so that it is not decoded and measured
+    /// again when it is drawn.
+    private struct TextRunKey: Hashable {
+        var text: String
+        var size: Float
+    }
+    private static let maxCachedTextRuns = 256
+    private var textRuns: [TextRunKey: UnsafeMutableRawPointer] = [:]
 
     public init(width w: Float = 1000, height h: Float = 660, fontPath: String = "") {
         self.fontPath = fontPath
@@ -78,6 +156,39 @@ public class AGGRenderer: Renderer{
                         agg_object)
     }
 
+    public func drawSolidRects(_ rects: [Rect], fillColors: [Color]) {
+        precondition(rects.count == fillColors.count, "drawSolidRects: expected one fill color for each rect.")
+        guard usesCompoundFills else {
+            for (rect, fillColor) in zip(rects, fillColors) {
+                drawSolidRect(rect, fillColor: fillColor, hatchPattern: .none)
+            }
+            return
+        }
+        var x = [Float]()
+        var y = [Float]()
+        var colors = [Float]()
+        x.reserveCapacity(rects.count * 4)
+        y.reserveCapacity(rects.count * 4)
+        colors.reserveCapacity(rects.count * 4)
+        for (rect, fillColor) in zip(rects, fillColors) {
+            let pts = getPoints(from: rect)
+            x.append(contentsOf: [pts.tL.x, pts.tR.x, pts.bR.x, pts.bL.x].map { $0 + xOffset })
+            y.append(contentsOf: [pts.tL.y, pts.tR.y, pts.bR.y, pts.bL.y].map { $0 + yOffset })
+            colors.append(contentsOf: [fillColor.r, fillColor.g, fillColor.b, fillColor.a])
+        }
+        // Each rect gets its own style, so later rects are drawn on top.
+        let counts = [Int32](repeating: 4, count: rects.count)
+        let styles = Array(0..<Int32(rects.count))
+        draw_compound_polygons(x,
+                               y,
+                               counts,
+                               styles,
+                               Int32(rects.count),
+                               colors,
+                               Int32(rects.count),
+                               agg_object)
+    }
+
     public func drawSolidRectWithBorder(_ rect: Rect,
                                         strokeWidth thickness: Float,
                                         fillColor: Color = Color.white,
@@ -156,6 +267,83 @@ public class AGGRenderer: Renderer{
                           agg_object);
     }
 
+    public func drawImage(_ pixels: [UInt8], width: Int, height: Int, in rect: Rect) {
+        precondition(pixels.count == width * height * 4, "drawImage: expected 4 bytes for each pixel.")
+        let rect = rect.normalized
+        draw_image(pixels,
+                   Int32(width),
+                   Int32(height),
+                   rect.origin.x + xOffset,
+                   rect.origin.y + yOffset,
+                   rect.size.width,
+                   rect.size.height,
+                   agg_object)
+    }
+
+    public var supportsIncrementalUpdates: Bool {
+        return true
+    }
+
+    public func moveRegion(_ rect: Rect, by offset: Point) {
+        let rect = rect.normalized
+        move_region(rect.origin.x + xOffset,
+                    rect.origin.y + yOffset,
+                    rect.size.width,
+                    rect.size.height,
+                    offset.x,
+                    offset.y,
+                    agg_object)
+    }
+
+    public func drawLayer(_ key: Int, in rect: Rect, isOpaque: Bool, draw: (Renderer) -> Void) {
+        guard cachesLayers else {
+            draw(self)
+            return
+        }
+        // A layer is kept for where and how it was drawn.
+        var hasher = Hasher()
+        hasher.combine(key)
+        hasher.combine(offset)
+        hasher.combine(fontIdentifier)
+        hasher.combine(usesGlyphAtlas)
+        hasher.combine(hairlineWidth)
+        hasher.combine(usesCompoundFills)
+        hasher.combine(renderQuality)
+        let layerKey = Int64(hasher.finalize())
+        let rect = rect.normalized
+        let frameRect = Rect(origin: Point(rect.origin.x + xOffset, rect.origin.y + yOffset), size: rect.size)
+        let savedClipRect = frameClipRect
+        defer { setFrameClipRect(savedClipRect) }
+        if let clipRect = savedClipRect, clipRect.minX > frameRect.minX || clipRect.maxX < frameRect.maxX
+            || clipRect.minY > frameRect.minY || clipRect.maxY < frameRect.maxY {
+            // Only part of the layer may be drawn, so it cannot be kept. It is drawn within
+            // both rects instead.
+            let minX = max(clipRect.minX, frameRect.minX)
+            let minY = max(clipRect.minY, frameRect.minY)
+            let maxX = min(clipRect.maxX, frameRect.maxX)
+            let maxY = min(clipRect.maxY, frameRect.maxY)
+            guard minX < maxX, minY < maxY else { return }
+            setFrameClipRect(Rect(origin: Point(minX, minY), size: Size(width: maxX - minX, height: maxY - minY)))
+            draw(self)
+            return
+        }
+        if draw_layer(layerKey, frameRect.origin.x, frameRect.origin.y,
+                      frameRect.size.width, frameRect.size.height, agg_object) {
+            return
+        }
+        // Pixels only partly covered by the layer are blended with what is beneath them.
+        let isOpaque = isOpaque && frameRect == frameRect.roundedInwards
+        setFrameClipRect(frameRect)
+        begin_layer(layerKey, frameRect.origin.x, frameRect.origin.y,
+                    frameRect.size.width, frameRect.size.height, !isOpaque, agg_object)
+        draw(self)
+        if !isOpaque {
+            next_layer_pass(agg_object)
+            draw(self)
+        }
+        end_layer(agg_object)
+    }
+
     public func drawSolidPolygon(_ polygon: SwiftPlot.Polygon,
                                  fillColor: Color) {
         var x = [Float]()
@@ -210,16 +398,39 @@ public class AGGRenderer: Renderer{
             y.append(point.y + yOffset)
         }
 
-        draw_plot_lines(x,
-                        y,
-                        Int32(x.count),
-                        thickness,
-                        strokeColor.r,
-                        strokeColor.g,
-                        strokeColor.b,
-                        strokeColor.a,
-                        isDashed,
-                        agg_object)
+        drawPlotLines(x, y, strokeWidth: thickness, strokeColor: strokeColor, isDashed: isDashed)
+    }
+
+    /// Transforms the series straight into the coordinate columns passed to the C renderer,
+    /// rather than building a `Polyline` of `Point`s first.
+    public func drawPolyline<T, U>(_ values: [Pair<T,U>],
+                                   transform: CoordinateTransform<T,U>,
+                                   strokeWidth thickness: Float,
+                                   strokeColor: Color,
+                                   isDashed: Bool) {
+        guard values.count >= 2 else { return }
+        let (x, y) = transform.apply(values, offset: Point(xOffset, yOffset))
+        drawPlotLines(x, y, strokeWidth: thickness, strokeColor: strokeColor, isDashed: isDashed)
+    }
+
+    private func drawPlotLines(_ x: [Float], _ y: [Float],
+                               strokeWidth thickness: Float,
+                               strokeColor: Color,
+                               isDashed: Bool) {
+        let complete = draw_plot_lines(x,
+                                       y,
+                                       Int32(x.count),
+                                       thickness,
+                                       strokeColor.r,
+                                       strokeColor.g,
+                                       strokeColor.b,
+                                       strokeColor.a,
+                                       isDashed,
+                                       agg_object)
+        if !complete {
+            // Only possible for absurdly thick lines; log it rather than drop it silently.
+            print("AGGRenderer: polyline of \(x.count) points exceeded the rasterizer's cell limit and was drawn incomplete.")
+        }
     }
 
     public func drawText(text s: String,
@@ -228,25 +439,66 @@ public class AGGRenderer: Renderer{
                          color: Color,
                          strokeWidth thickness: Float,
                          angle: Float){
-        draw_text(s,
-                  p.x + xOffset,
-                  p.y + yOffset,
-                  size,
-                  color.r,
-                  color.g,
-                  color.b,
-                  color.a,
-                  thickness,
-                  angle,
-                  agg_object)
+        draw_text_run(textRun(s, size: size),
+                      p.x + xOffset,
+                      p.y + yOffset,
+                      color.r,
+                      color.g,
+                      color.b,
+                      color.a,
+                      thickness,
+                      angle,
+                      agg_object)
     }
 
     public func getTextLayoutSize(text: String, textSize size: Float) -> Size {
         var width: Float = 0, height: Float = 0
-        get_text_size(text, size, &width, &height, agg_object)
+        get_text_run_size(textRun(text, size: size), &width, &height)
         return Size(width: width, height: height)
     }
 
+    public func setClipRect(_ rect: Rect?) {
+        setFrameClipRect(rect.map { clipRect -> Rect in
+            let rect = clipRect.normalized
+            return Rect(origin: Point(rect.origin.x + xOffset, rect.origin.y + yOffset), size: rect.size)
+        })
+    }
+
+    private func setFrameClipRect(_ rect: Rect?) {
+        frameClipRect = rect
+        guard let rect = rect else {
+            reset_clip_rect(agg_object)
+            return
+        }
+        set_clip_rect(rect.origin.x, rect.origin.y, rect.size.width, rect.size.height, agg_object)
+    }
+
+    public var fontIdentifier: String {
+        let identifier = usesKerning ? fontPath + "#kerning" : fontPath
+        return renderQuality == .draft ? identifier + "#draft" : identifier
+    }
+
+    /// Returns the text run for the given string, creating it if it is not cached.
+    private func textRun(_ text: String, size: Float) -> UnsafeMutableRawPointer {
+        let key = TextRunKey(text: text, size: size)
+        if let run = textRuns[key] {
+            return run
+        }
+        if textRuns.count >= AGGRenderer.maxCachedTextRuns {
+            removeTextRuns()
+        }
+        let run: UnsafeMutableRawPointer = create_text_run(text, size, agg_object)
+        textRuns[key] = run
+        return run
+    }
+
+    private func removeTextRuns() {
+        for run in textRuns.values {
+            delete_text_run(run)
+        }
+        textRuns.removeAll()
+    }
+
     struct DrawOutputError: Error, CustomStringConvertible {
         let errorCode: UInt32
         let description: String
@@ -260,32 +512,38 @@ public class AGGRenderer: Renderer{
         }
     }
 
-    public func base64Png() -> String {
+    /// Returns the image encoded as a PNG file.
+    public func pngData() throws -> Data {
       var _bufferPtr: UnsafeMutablePointer<UInt8>?
       var errorDescPtr: UnsafePointer<Int8>?
       var bufferSize = 0
 
       let err = create_png_buffer(&_bufferPtr, &bufferSize, &errorDescPtr, agg_object)
       guard let bufferPtr = _bufferPtr, err == 0 else {
-        // We'll probably never make this throwing, but log the error all the same.
-        print(
-          errorDescPtr.map { "Error rendering image: \(String(cString: $0))"} ??
-          "lodepng failed to render, but didn't produce an error."
+        throw DrawOutputError(
+          errorCode: err,
+          description: errorDescPtr.map { String(cString: $0) } ??
+            "lodepng failed to render, but didn't produce an error."
         )
-        return ""
       }
 
-      let base64String = Data(
-        bytesNoCopy: UnsafeMutableRawPointer(mutating: bufferPtr),
-        count: bufferSize,
-        deallocator: .none
-      ).base64EncodedString()
-
+      let data = Data(bytes: bufferPtr, count: bufferSize)
       free_png_buffer(&_bufferPtr)
-      return base64String
+      return data
+    }
+
+    public func base64Png() -> String {
+      do {
+        return try pngData().base64EncodedString()
+      } catch {
+        // We'll probably never make this throwing, but log the error all the same.
+        print("Error rendering image: \(error)")
+        return ""
+      }
     }
 
     deinit {
+        removeTextRuns()
         delete_plot(agg_object)
     }
 
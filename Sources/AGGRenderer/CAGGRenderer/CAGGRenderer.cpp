@@ -10,6 +10,10 @@ void delete_plot(void *object){
   CPPAGGRenderer::delete_plot(object);
 }
 
+void reset_plot(float w, float h, const void *object){
+  CPPAGGRenderer::reset_plot(w, h, object);
+}
+
 void draw_rect(const float *x, const float *y, float thickness, float r, float g, float b, float a, const void *object){
   CPPAGGRenderer::draw_rect(x, y, thickness, r, g, b, a, object);
 }
@@ -38,12 +42,44 @@ void draw_solid_polygon(const float* x, const float* y, int count, float r, floa
   CPPAGGRenderer::draw_solid_polygon(x, y, count, r, g, b, a, object);
 }
 
+void draw_compound_polygons(const float* x, const float* y, const int* counts, const int* styles, int count, const float* colors, int style_count, const void *object){
+  CPPAGGRenderer::draw_compound_polygons(x, y, counts, styles, count, colors, style_count, object);
+}
+
+void draw_image(const unsigned char *rgba, int width, int height, float x, float y, float w, float h, const void *object){
+  CPPAGGRenderer::draw_image(rgba, width, height, x, y, w, h, object);
+}
+
+void move_region(float x, float y, float w, float h, float dx, float dy, const void *object){
+  CPPAGGRenderer::move_region(x, y, w, h, dx, dy, object);
+}
+
+bool draw_layer(long long key, float x, float y, float w, float h, const void *object){
+  return CPPAGGRenderer::draw_layer(key, x, y, w, h, object);
+}
+
+void begin_layer(long long key, float x, float y, float w, float h, bool overlay, const void *object){
+  CPPAGGRenderer::begin_layer(key, x, y, w, h, overlay, object);
+}
+
+void next_layer_pass(const void *object){
+  CPPAGGRenderer::next_layer_pass(object);
+}
+
+void end_layer(const void *object){
+  CPPAGGRenderer::end_layer(object);
+}
+
+void clear_layers(const void *object){
+  CPPAGGRenderer::clear_layers(object);
+}
+
 void draw_line(const float *x, const float *y, float thickness, float r, float g, float b, float a, bool is_dashed, const void *object){
   CPPAGGRenderer::draw_line(x, y, thickness, r, g, b, a, is_dashed, object);
 }
 
-void draw_plot_lines(const float *x, const float *y, int size, float thickness, float r, float g, float b, float a, bool isDashed, const void *object){
-  CPPAGGRenderer::draw_plot_lines(x, y, size, thickness, r, g, b, a, isDashed, object);
+bool draw_plot_lines(const float *x, const float *y, int size, float thickness, float r, float g, float b, float a, bool isDashed, const void *object){
+  return CPPAGGRenderer::draw_plot_lines(x, y, size, thickness, r, g, b, a, isDashed, object);
 }
 
 void draw_text(const char *s, float x, float y, float size, float r, float g, float b, float a, float thickness, float angle, const void *object){
@@ -54,6 +90,46 @@ void get_text_size(const char *s, float size, float* outW, float* outH, const vo
   return CPPAGGRenderer::get_text_size(s, size, outW, outH, object);
 }
 
+void * create_text_run(const char *s, float size, const void *object){
+  return CPPAGGRenderer::create_text_run(s, size, object);
+}
+
+void get_text_run_size(const void *run, float* outW, float* outH){
+  CPPAGGRenderer::get_text_run_size(run, outW, outH);
+}
+
+void draw_text_run(const void *run, float x, float y, float r, float g, float b, float a, float thickness, float angle, const void *object){
+  CPPAGGRenderer::draw_text_run(run, x, y, r, g, b, a, thickness, angle, object);
+}
+
+void delete_text_run(void *run){
+  CPPAGGRenderer::delete_text_run(run);
+}
+
+void set_text_kerning(bool enabled, const void *object){
+  CPPAGGRenderer::set_text_kerning(enabled, object);
+}
+
+void set_glyph_atlas(bool enabled, const void *object){
+  CPPAGGRenderer::set_glyph_atlas(enabled, object);
+}
+
+void set_hairline_width(float width, const void *object){
+  CPPAGGRenderer::set_hairline_width(width, object);
+}
+
+void set_render_quality(int quality, const void *object){
+  CPPAGGRenderer::set_render_quality(quality, object);
+}
+
+void set_clip_rect(float x, float y, float width, float height, const void *object){
+  CPPAGGRenderer::set_clip_rect(x, y, width, height, object);
+}
+
+void reset_clip_rect(const void *object){
+  CPPAGGRenderer::reset_clip_rect(object);
+}
+
 unsigned save_image(const char *s, const char** errorDesc, const void *object){
   return CPPAGGRenderer::save_image(s, errorDesc, object);
 }
@@ -1,11 +1,24 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 #include "string.h"
 
 #include "include/CPPAGGRenderer.h"
 //agg rendering library
 #include "agg_basics.h"
+#include "agg_clip_liang_barsky.h"
 #include "agg_rendering_buffer.h"
 #include "agg_rasterizer_scanline_aa.h"
+#include "agg_rasterizer_compound_aa.h"
+#include "agg_rasterizer_outline_aa.h"
+#include "agg_renderer_outline_aa.h"
 #include "agg_scanline_p.h"
 #include "agg_pixfmt_rgb.h"
 #include "agg_path_storage.h"
@@ -23,6 +36,9 @@
 #include "agg_span_pattern_rgb.h"
 #include "agg_span_pattern_rgba.h"
 #include "agg_image_accessors.h"
+#include "agg_pixfmt_rgba.h"
+#include "agg_span_image_filter_rgba.h"
+#include "agg_span_interpolator_linear.h"
 //lodepng library
 #include "lodepng.h"
 //header to save bitmaps
@@ -30,16 +46,20 @@
 #define AGG_RGB24
 #include "include/pixel_formats.h"
 
-typedef agg::pixfmt_rgb24 pixfmt;
 typedef agg::renderer_base<pixfmt> renderer_base;
 typedef agg::renderer_base<pixfmt_pre> renderer_base_pre;
 typedef agg::renderer_scanline_aa_solid<renderer_base> renderer_aa;
 typedef agg::renderer_scanline_bin_solid<renderer_base> renderer_bin;
+typedef agg::renderer_outline_aa<renderer_base> renderer_outline;
+typedef agg::rasterizer_outline_aa<renderer_outline> rasterizer_outline;
 typedef agg::font_engine_freetype_int32 font_engine_type;
 typedef agg::font_cache_manager<font_engine_type> font_manager_type;
 typedef agg::rasterizer_scanline_aa<> rasterizer_scanline;
 typedef agg::scanline_p8 scanline;
 typedef agg::rgba Color;
+// Every path is built from float coordinates, so float vertices lose nothing and take
+// half the memory of agg::path_storage's doubles.
+typedef agg::path_base<agg::vertex_block_storage<float> > path_storage;
 
 const Color black(0.0,0.0,0.0,1.0);
 const Color blue_light(0.529,0.808,0.922,1.0);
@@ -65,17 +85,394 @@ namespace CPPAGGRenderer{
                             unsigned char **output, size_t *outputSize, const char **errorDesc){
     //Encode the image
     LodePNGColorType colorType = LCT_RGB;
-    unsigned error = lodepng_encode_memory(output, outputSize, image, w, h, colorType, 8);
+    unsigned error = lodepng_encode_memory(output, outputSize, image, width, height, colorType, 8);
     if(error && errorDesc)
         *errorDesc = lodepng_error_text(error);
     return error;
   }
 
+  // Returns the contents of a font file, reading it only if no other plot is using it.
+  // The data is immutable once read, so plots on different threads can share it; each
+  // plot creates its own FreeType library and faces from it.
+  std::shared_ptr<const std::vector<char>> shared_font_data(const string& path){
+    static std::mutex mutex;
+    static std::map<string, std::weak_ptr<const std::vector<char>>> fonts;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<const std::vector<char>> data = fonts[path].lock();
+    if(data)
+      return data;
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if(!file)
+      return data;
+    data = std::make_shared<const std::vector<char>>(std::istreambuf_iterator<char>(file),
+                                                     std::istreambuf_iterator<char>());
+    fonts[path] = data;
+    return data;
+  }
+
+  // Decodes UTF-8 text into code points, replacing malformed sequences with U+FFFD.
+  std::vector<unsigned> decode_utf8(const char *s){
+    static const unsigned min_code[] = {0, 0x80, 0x800, 0x10000};
+    std::vector<unsigned> codes;
+    const unsigned char *p = (const unsigned char *)s;
+    while(*p){
+      unsigned lead = *p;
+      int extra = lead < 0x80 ? 0 : (lead >> 5) == 0x6 ? 1 : (lead >> 4) == 0xE ? 2 : (lead >> 3) == 0x1E ? 3 : -1;
+      if(extra < 0){
+        codes.push_back(0xFFFD);
+        ++p;
+        continue;
+      }
+      unsigned code = extra == 0 ? lead : lead & (0x3F >> extra);
+      int i = 1;
+      // A terminating zero is not a continuation byte, so this never reads past the end.
+      for(; i <= extra && (p[i] & 0xC0) == 0x80; i++){
+        code = (code << 6) | (p[i] & 0x3F);
+      }
+      if(i <= extra){
+        codes.push_back(0xFFFD);
+        p += i;
+        continue;
+      }
+      if(code < min_code[extra] || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF))
+        code = 0xFFFD;
+      codes.push_back(code);
+      p += extra + 1;
+    }
+    return codes;
+  }
+
+  // A vertex source for a polyline given as separate arrays of x and y coordinates.
+  class polyline_arrays{
+    const float *x;
+    const float *y;
+    int size;
+    int index;
+
+  public:
+    polyline_arrays(const float *x, const float *y, int size) : x(x), y(y), size(size), index(0) {}
+
+    void rewind(unsigned){
+      index = 0;
+    }
+
+    unsigned vertex(double *vx, double *vy){
+      if(index >= size)
+        return agg::path_cmd_stop;
+      *vx = x[index];
+      *vy = y[index];
+      return index++ == 0 ? agg::path_cmd_move_to : agg::path_cmd_line_to;
+    }
+  };
+
+  // Fills paths made only of horizontal and vertical edges, such as rectangles and the
+  // strokes of horizontal and vertical lines, without the scanline rasterizer.
+  //
+  // Only vertical edges add coverage, so each row's cells can be worked out directly
+  // from the edges crossing it. The cells are swept with the same arithmetic as
+  // rasterizer_scanline_aa, so the result is identical, but no cells are stored or
+  // sorted, and runs of identical rows, such as the interior of a rectangle, are swept
+  // once and blended as bars.
+  class AxisAlignedFiller{
+    // A vertical edge from (x, y1) to (x, y2), in subpixel units.
+    struct Edge{
+      int x, y1, y2;
+    };
+    struct Cell{
+      int x, cover, area;
+    };
+    // Pixels x1...x2 of a row, blended with the given coverage.
+    struct Span{
+      int x1, x2;
+      unsigned alpha;
+    };
+    std::vector<Edge> edges;
+    std::vector<int> rows;
+    std::vector<Cell> cells;
+    std::vector<Span> spans;
+    bool aliased = false;
+
+  public:
+    // Fills the path, returning false without drawing anything if it has an edge which
+    // is neither horizontal nor vertical. An aliased fill covers pixels fully or not at
+    // all, as a rasterizer with a 0.5 threshold gamma and a binary scanline would.
+    template<class VertexSource, class BaseRenderer>
+    bool fill(VertexSource& path, BaseRenderer& rb, const typename BaseRenderer::color_type& c, bool aliased = false){
+      if(!collect_edges(path))
+        return false;
+      this->aliased = aliased;
+      if(edges.empty())
+        return true;
+
+      // Rows in which an edge starts or ends are partly covered. The rows between two of
+      // them are all alike, so only one of them needs to be swept.
+      rows.clear();
+      for(size_t i = 0; i < edges.size(); i++){
+        rows.push_back(edges[i].y1 >> agg::poly_subpixel_shift);
+        rows.push_back(edges[i].y2 >> agg::poly_subpixel_shift);
+      }
+      std::sort(rows.begin(), rows.end());
+      rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+      for(size_t i = 0; i < rows.size(); i++){
+        blend_rows(rb, c, rows[i], rows[i]);
+        if(i + 1 < rows.size() && rows[i + 1] > rows[i] + 1)
+          blend_rows(rb, c, rows[i] + 1, rows[i + 1] - 1);
+      }
+      return true;
+    }
+
+  private:
+    template<class VertexSource>
+    bool collect_edges(VertexSource& path){
+      // Beyond this the subpixel arithmetic could overflow.
+      static const double max_coordinate = 1 << 20;
+      edges.clear();
+      int start_x = 0, start_y = 0, last_x = 0, last_y = 0;
+      double x, y;
+      unsigned cmd;
+      path.rewind(0);
+      // Like the rasterizer, close every contour.
+      while(!agg::is_stop(cmd = path.vertex(&x, &y))){
+        if(agg::is_vertex(cmd)){
+          if(!(fabs(x) < max_coordinate && fabs(y) < max_coordinate))
+            return false;
+          int vx = agg::iround(x * agg::poly_subpixel_scale);
+          int vy = agg::iround(y * agg::poly_subpixel_scale);
+          if(agg::is_move_to(cmd)){
+            if(!add_edge(last_x, last_y, start_x, start_y))
+              return false;
+            start_x = vx;
+            start_y = vy;
+          }
+          else if(!add_edge(last_x, last_y, vx, vy)){
+            return false;
+          }
+          last_x = vx;
+          last_y = vy;
+        }
+        else if(agg::is_close(cmd)){
+          if(!add_edge(last_x, last_y, start_x, start_y))
+            return false;
+          last_x = start_x;
+          last_y = start_y;
+        }
+      }
+      return add_edge(last_x, last_y, start_x, start_y);
+    }
+
+    bool add_edge(int x1, int y1, int x2, int y2){
+      if(y1 == y2)
+        return true;
+      if(x1 != x2)
+        return false;
+      Edge edge = {x1, y1, y2};
+      edges.push_back(edge);
+      return true;
+    }
+
+    // Works out the cells of the row, as rasterizer_cells_aa would, and sweeps them into
+    // spans as rasterizer_scanline_aa::sweep_scanline would.
+    void sweep_row(int row){
+      int top = row << agg::poly_subpixel_shift;
+      int bottom = top + agg::poly_subpixel_scale;
+      cells.clear();
+      for(size_t i = 0; i < edges.size(); i++){
+        const Edge& edge = edges[i];
+        int overlap = std::min(std::max(edge.y1, edge.y2), bottom) - std::max(std::min(edge.y1, edge.y2), top);
+        if(overlap <= 0)
+          continue;
+        Cell cell;
+        cell.x = edge.x >> agg::poly_subpixel_shift;
+        cell.cover = edge.y2 > edge.y1 ? overlap : -overlap;
+        cell.area = 2 * (edge.x - (cell.x << agg::poly_subpixel_shift)) * cell.cover;
+        // Insertion sort; there are only ever a few cells.
+        size_t j = cells.size();
+        cells.push_back(cell);
+        for(; j > 0 && cells[j - 1].x > cell.x; j--)
+          cells[j] = cells[j - 1];
+        cells[j] = cell;
+      }
+
+      spans.clear();
+      int cover = 0;
+      size_t i = 0;
+      while(i < cells.size()){
+        int x = cells[i].x;
+        int area = cells[i].area;
+        cover += cells[i].cover;
+        for(++i; i < cells.size() && cells[i].x == x; ++i){
+          area += cells[i].area;
+          cover += cells[i].cover;
+        }
+        if(area){
+          add_span(x, x, alpha((cover << (agg::poly_subpixel_shift + 1)) - area));
+          x++;
+        }
+        if(i < cells.size() && cells[i].x > x){
+          add_span(x, cells[i].x - 1, alpha(cover << (agg::poly_subpixel_shift + 1)));
+        }
+      }
+    }
+
+    // rasterizer_scanline_aa::calculate_alpha, for the non-zero rule and linear gamma, or
+    // the 0.5 threshold gamma if the fill is aliased.
+    unsigned alpha(int area) const {
+      int cover = area >> (agg::poly_subpixel_shift*2 + 1 - 8);
+      if(cover < 0) cover = -cover;
+      if(cover > 255) cover = 255;
+      return aliased ? (cover < 128 ? 0 : 255) : cover;
+    }
+
+    void add_span(int x1, int x2, unsigned alpha){
+      if(alpha){
+        Span span = {x1, x2, alpha};
+        spans.push_back(span);
+      }
+    }
+
+    // Blends rows first_row...last_row, which all have the same cells, clipped to the
+    // renderer's bounds.
+    template<class BaseRenderer>
+    void blend_rows(BaseRenderer& rb, const typename BaseRenderer::color_type& c, int first_row, int last_row){
+      first_row = std::max(first_row, rb.ymin());
+      last_row = std::min(last_row, rb.ymax());
+      if(first_row > last_row)
+        return;
+      sweep_row(first_row);
+      for(size_t i = 0; i < spans.size(); i++){
+        const Span& span = spans[i];
+        rb.blend_bar(span.x1, first_row, span.x2, last_row, c, span.alpha);
+      }
+    }
+  };
+
+  // A string which has been decoded and measured once, and can then be drawn any number
+  // of times at different positions and angles. Glyphs are looked up in the font cache
+  // again when the run is drawn; the positions are only used for the glyph atlas.
+  struct TextRun{
+    // The code point and horizontal position of each glyph, relative to the start of the
+    // run. Characters without a glyph are left out.
+    std::vector<unsigned> codes;
+    std::vector<float> positions;
+    float size = 0;
+    bool kerning = false;
+    float width = 0;
+    float height = 0;
+  };
+
+  // Coverage masks of glyphs, rasterized once for each size and horizontal subpixel offset
+  // and packed into a single 8-bit buffer. Repeated text, such as tick labels, can then be
+  // composited with one span blend per row instead of going through the scanline adaptors.
+  class GlyphAtlas{
+  public:
+    static const int subpixel_steps = 4;
+    // Once the atlas holds this many bytes of coverage, it is cleared.
+    static const size_t max_coverage_size = 4 << 20;
+
+    struct Glyph{
+      // The offset of the bottom-left pixel of the mask from the pen position.
+      int x;
+      int y;
+      unsigned width;
+      unsigned height;
+      size_t offset;
+    };
+
+    const Glyph* find(unsigned code, float size, int subpixel) const{
+      std::unordered_map<uint64_t, Glyph>::const_iterator it = glyphs.find(key(code, size, subpixel));
+      return it == glyphs.end() ? 0 : &it->second;
+    }
+
+    // Adds the coverage of the path in the rasterizer as the mask of the given glyph.
+    template<class Rasterizer>
+    const Glyph* insert(unsigned code, float size, int subpixel, Rasterizer& ras){
+      if(coverage.size() > max_coverage_size){
+        glyphs.clear();
+        coverage.clear();
+      }
+      Glyph glyph = {0, 0, 0, 0, coverage.size()};
+      if(ras.rewind_scanlines()){
+        glyph.x = ras.min_x();
+        glyph.y = ras.min_y();
+        glyph.width = ras.max_x() - ras.min_x() + 1;
+        glyph.height = ras.max_y() - ras.min_y() + 1;
+        coverage.resize(coverage.size() + glyph.width * glyph.height, 0);
+        agg::scanline_u8 sl;
+        sl.reset(ras.min_x(), ras.max_x());
+        while(ras.sweep_scanline(sl)){
+          agg::int8u *row = &coverage[glyph.offset + (sl.y() - glyph.y) * glyph.width];
+          unsigned num_spans = sl.num_spans();
+          agg::scanline_u8::const_iterator span = sl.begin();
+          for(;;){
+            memcpy(row + span->x - glyph.x, span->covers, span->len);
+            if(--num_spans == 0) break;
+            ++span;
+          }
+        }
+      }
+      return &(glyphs[key(code, size, subpixel)] = glyph);
+    }
+
+    // Blends the glyph's mask in the given color, with the pen at (x, y).
+    template<class Renderer>
+    void blend(Renderer& rb, const Glyph& glyph, int x, int y, const typename Renderer::color_type& color) const{
+      for(unsigned row = 0; row < glyph.height; row++){
+        const agg::int8u *covers = &coverage[glyph.offset + row * glyph.width];
+        // Only blend the covered part of the row.
+        unsigned begin = 0;
+        unsigned end = glyph.width;
+        while(begin < end && covers[begin] == 0) ++begin;
+        while(end > begin && covers[end - 1] == 0) --end;
+        if(begin < end)
+          rb.blend_solid_hspan(x + glyph.x + begin, y + glyph.y + row, end - begin, color, covers + begin);
+      }
+    }
+
+  private:
+    // Packs the code point (21 bits), the bits of the size and the subpixel offset (2 bits).
+    static uint64_t key(unsigned code, float size, int subpixel){
+      uint32_t size_bits;
+      memcpy(&size_bits, &size, sizeof(size_bits));
+      return (uint64_t(code) << 34) | (uint64_t(size_bits) << 2) | uint64_t(subpixel);
+    }
+
+    std::unordered_map<uint64_t, Glyph> glyphs;
+    std::vector<agg::int8u> coverage;
+  };
+
+  // The solid colors of the styles passed to render_scanlines_compound_layered. It mixes
+  // the styles covering a pixel before blending them, so the colors are premultiplied.
+  class CompoundStyles{
+  public:
+    std::vector<color_type> colors;
+
+    bool is_solid(unsigned) const { return true; }
+    const color_type& color(unsigned style) const { return colors[style]; }
+    void generate_span(color_type*, int, int, unsigned, unsigned) {}
+  };
+
   class Plot{
+  public:
+    // Draft quality fills with aliased scanlines, approximates curves coarsely and draws
+    // unrotated text from hinted FreeType bitmaps. High quality approximates curves finely.
+    enum render_quality { quality_draft = 0, quality_normal = 1, quality_high = 2 };
+
+  private:
+    // The cells a polyline may need before it is drawn in pieces: about 16 MiB.
+    static const unsigned polyline_chunk_cells = 1 << 20;
+    // The default cell limit of agg::rasterizer_cells_aa: 1024 blocks of 4096 cells.
+    static const unsigned rasterizer_cell_limit = 1024 * 4096;
+
     agg::rasterizer_scanline_aa<> m_ras;
     agg::scanline_p8              m_sl_p8;
+    agg::rasterizer_compound_aa<> m_ras_compound;
+    agg::scanline_u8              m_sl_u8;
+    agg::span_allocator<color_type> m_compound_alloc;
+    CompoundStyles compound_styles;
+    agg::scanline_bin             m_sl_bin;
     agg::line_cap_e buttCap = agg::butt_cap;
     renderer_aa ren_aa;
+    renderer_bin ren_bin;
 
     font_engine_type  m_feng;
     font_manager_type m_fman;
@@ -87,15 +484,57 @@ namespace CPPAGGRenderer{
     int font_height = 0;
     int font_width = 0;
     bool font_hinting = false;
-    bool font_kerning = true;
+    bool font_kerning = false;
+    bool glyph_atlas_enabled = false;
+    int quality = quality_normal;
+    // The scale passed to curve and ellipse approximations.
+    double approximation_scale = 2.0;
+    // Drawing is restricted to clip_rect when it is enabled.
+    bool clip_rect_enabled = false;
+    agg::rect_d clip_rect;
+    // Polylines no wider than this are drawn with the outline renderer. 0 disables it.
+    float hairline_width = 0;
+    agg::line_profile_aa hairline_profile;
+    float hairline_profile_width = -1;
+    // The font settings last passed to the font engine.
+    bool font_selected = false;
+    int selected_height = 0;
+    float selected_angle = 0;
+    agg::glyph_rendering selected_rendering = agg::glyph_ren_agg_gray8;
+    GlyphAtlas glyph_atlas;
+    AxisAlignedFiller axis_aligned_filler;
     string fontPath = "";
+    std::shared_ptr<const std::vector<char>> font_data;
 
     unsigned char* buffer = NULL;
     int frame_width = 1000;
     int frame_height = 660;
 
-    agg::int8u*           m_pattern;
+    // Layers of the image kept by end_layer, with the most recently drawn last. An opaque
+    // layer is a copy of its pixels. An overlay is drawn over the pixels beneath it, each
+    // channel c becoming base + scale * c / 255, where base and base + scale are what the
+    // layer drew over black and over white.
+    struct Layer{
+      long long key;
+      int x1, y1, x2, y2;
+      bool overlay;
+      std::vector<unsigned char> base;
+      std::vector<unsigned char> scale;
+    };
+    static const size_t max_layers = 16;
+    std::vector<Layer> layers;
+    // The layer being drawn between begin_layer and end_layer, and the pixels beneath it.
+    Layer pending_layer;
+    std::vector<unsigned char> pending_under;
+
+    static const int pattern_size = 10;
+    agg::int8u            m_pattern[pattern_size * pattern_size * 3];
     agg::rendering_buffer m_pattern_rbuf;
+    path_storage          m_pattern_path;
+    // The path built by each draw call. Its vertex blocks are kept between calls, unless
+    // the last path was unusually large.
+    static const unsigned max_kept_path_vertices = 1 << 16;
+    path_storage          m_path;
     renderer_base_pre rb_pre;
 
   public:
@@ -110,7 +549,7 @@ namespace CPPAGGRenderer{
     {
       buffer = new unsigned char[frame_width*frame_height*3];
       memset(buffer, 255, frame_width*frame_height*3);
-      m_curves.approximation_scale(2.0);
+      m_curves.approximation_scale(approximation_scale);
       m_contour.auto_detect_orientation(false);
       fontPath = fontPathPtr;
       if(fontPath.empty()){
@@ -118,16 +557,31 @@ namespace CPPAGGRenderer{
         string dir_path = file_path.substr(0, file_path.rfind("/"));
         fontPath = dir_path.append("/Roboto-Regular.ttf");
       }
+      font_data = shared_font_data(fontPath);
     }
 
     ~Plot() {
       delete [] buffer;
     }
 
+    // Clears the image to white, resizing it if needed. The font engine, the selected
+    // font and the glyph atlas are kept, so the next plot's text is drawn warm.
+    void reset(float width, float height){
+      int new_width = width;
+      int new_height = height;
+      if (new_width != frame_width || new_height != frame_height) {
+        delete [] buffer;
+        frame_width = new_width;
+        frame_height = new_height;
+        buffer = new unsigned char[frame_width*frame_height*3];
+      }
+      memset(buffer, 255, frame_width*frame_height*3);
+      clip_rect_enabled = false;
+    }
+
     void generate_pattern(float r, float g, float b, float a, int hatch_pattern){
-      agg::path_storage m_ps;
-      int size = 10;
-      m_pattern = new agg::int8u[size * size * 3];
+      m_pattern_path.remove_all();
+      const int size = pattern_size;
       m_pattern_rbuf.attach(m_pattern, size, size, size*3);
       pixfmt pixf_pattern(m_pattern_rbuf);
       agg::renderer_base<pixfmt> rb_pattern(pixf_pattern);
@@ -138,9 +592,9 @@ namespace CPPAGGRenderer{
           break;
         case 1:
           {
-            m_ps.move_to(0,0);
-            m_ps.line_to(size, size);
-            agg::conv_stroke<agg::path_storage> stroke(m_ps);
+            m_pattern_path.move_to(0,0);
+            m_pattern_path.line_to(size, size);
+            agg::conv_stroke<path_storage> stroke(m_pattern_path);
             stroke.width(1);
             stroke.line_cap(agg::butt_cap);
             m_ras.add_path(stroke);
@@ -148,9 +602,9 @@ namespace CPPAGGRenderer{
           }
         case 2:
           {
-            m_ps.move_to(0,size);
-            m_ps.line_to(size, 0);
-            agg::conv_stroke<agg::path_storage> stroke(m_ps);
+            m_pattern_path.move_to(0,size);
+            m_pattern_path.line_to(size, 0);
+            agg::conv_stroke<path_storage> stroke(m_pattern_path);
             stroke.width(1);
             m_ras.add_path(stroke);
             break;
@@ -171,40 +625,40 @@ namespace CPPAGGRenderer{
           }
         case 5:
           {
-            m_ps.move_to(size/2, 0);
-            m_ps.line_to(size/2, size);
-            agg::conv_stroke<agg::path_storage> stroke(m_ps);
+            m_pattern_path.move_to(size/2, 0);
+            m_pattern_path.line_to(size/2, size);
+            agg::conv_stroke<path_storage> stroke(m_pattern_path);
             stroke.width(1);
             m_ras.add_path(stroke);
             break;
           }
         case 6:
           {
-            m_ps.move_to(0, size/2);
-            m_ps.line_to(size, size/2);
-            agg::conv_stroke<agg::path_storage> stroke(m_ps);
+            m_pattern_path.move_to(0, size/2);
+            m_pattern_path.line_to(size, size/2);
+            agg::conv_stroke<path_storage> stroke(m_pattern_path);
             stroke.width(1);
             m_ras.add_path(stroke);
             break;
           }
         case 7:
           {
-            m_ps.move_to(size/2, 0);
-            m_ps.line_to(size/2, size);
-            m_ps.move_to(0, size/2);
-            m_ps.line_to(size, size/2);
-            agg::conv_stroke<agg::path_storage> stroke(m_ps);
+            m_pattern_path.move_to(size/2, 0);
+            m_pattern_path.line_to(size/2, size);
+            m_pattern_path.move_to(0, size/2);
+            m_pattern_path.line_to(size, size/2);
+            agg::conv_stroke<path_storage> stroke(m_pattern_path);
             stroke.width(1);
             m_ras.add_path(stroke);
             break;
           }
         case 8:
           {
-            m_ps.move_to(0, 0);
-            m_ps.line_to(size, size);
-            m_ps.move_to(0, size);
-            m_ps.line_to(size, 0);
-            agg::conv_stroke<agg::path_storage> stroke(m_ps);
+            m_pattern_path.move_to(0, 0);
+            m_pattern_path.line_to(size, size);
+            m_pattern_path.move_to(0, size);
+            m_pattern_path.line_to(size, 0);
+            agg::conv_stroke<path_storage> stroke(m_pattern_path);
             stroke.width(1);
             m_ras.add_path(stroke);
             break;
@@ -216,14 +670,87 @@ namespace CPPAGGRenderer{
       agg::render_scanlines(m_ras, m_sl_p8, rs_pattern);
     }
 
+    void attach_renderers(renderer_base& rb){
+      ren_aa = renderer_aa(rb);
+      ren_bin.attach(rb);
+    }
+
+    // Sweeps m_ras into the renderer attached last, in ren_aa's color. In draft quality
+    // pixels are either filled or left alone, which skips blending by coverage.
+    void render_solid(){
+      if(quality == quality_draft){
+        ren_bin.color(ren_aa.color());
+        agg::render_scanlines(m_ras, m_sl_bin, ren_bin);
+      }
+      else {
+        agg::render_scanlines(m_ras, m_sl_p8, ren_aa);
+      }
+    }
+
+    // The number of segments in the outline of an ellipse. Normal quality always uses 100,
+    // which is plenty for markers; other qualities fit the count to the ellipse's size.
+    unsigned ellipse_steps(double rx, double ry) const {
+      if(quality == quality_normal)
+        return 100;
+      double ra = (fabs(rx) + fabs(ry)) / 2;
+      double da = acos(ra / (ra + 0.125 / approximation_scale)) * 2;
+      unsigned steps = da > 0 ? agg::uround(2 * agg::pi / da) : 100;
+      return quality == quality_draft ? std::max(steps, 8u) : std::max(steps, 100u);
+    }
+
+    // The glyph rendering used for text at the given angle.
+    agg::glyph_rendering text_rendering(float angle) const {
+      return quality == quality_draft && angle == 0 ? agg::glyph_ren_native_gray8 : gren;
+    }
+
+    // Empties the shared path, keeping its memory for the next one.
+    path_storage& reset_path(){
+      if (m_path.total_vertices() > max_kept_path_vertices)
+        m_path.free_all();
+      else
+        m_path.remove_all();
+      return m_path;
+    }
+
+    // Restricts the renderer to the pixels touched by the clip rect, if one is set.
+    template<class BaseRenderer>
+    void apply_clip_rect(BaseRenderer& rb) const {
+      if(!clip_rect_enabled)
+        return;
+      agg::rect_d box = visible_box(0);
+      rb.clip_box(int(floor(box.x1)), int(floor(box.y1)), int(ceil(box.x2)) - 1, int(ceil(box.y2)) - 1);
+    }
+
+    // The clip rect, or the whole image if there is none, widened by margin on every side.
+    // Geometry outside it is left out before stroking.
+    agg::rect_d visible_box(double margin) const {
+      agg::rect_d box(0, 0, frame_width, frame_height);
+      if(clip_rect_enabled && !box.clip(clip_rect))
+        box = agg::rect_d(0, 0, 0, 0);
+      return agg::rect_d(box.x1 - margin, box.y1 - margin, box.x2 + margin, box.y2 + margin);
+    }
+
+    // Fills the path in the given color. Paths made only of horizontal and vertical edges
+    // skip the scanline rasterizer, with the same result.
+    template<class VertexSource>
+    void render_path(VertexSource& path, renderer_base& rb, const Color& c){
+      if(axis_aligned_filler.fill(path, rb, c, quality == quality_draft))
+        return;
+      m_ras.add_path(path);
+      ren_aa.color(c);
+      render_solid();
+    }
+
     void draw_solid_rect(const float *x, const float *y, float r, float g, float b, float a, int hatch_pattern){
       agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
       pixfmt pixf = pixfmt(rbuf);
       renderer_base rb = renderer_base(pixf);
-      ren_aa = renderer_aa(rb);
+      apply_clip_rect(rb);
+      attach_renderers(rb);
       pixfmt_pre pixf_pre(rbuf);
       renderer_base_pre rb_pre(pixf_pre);
-      agg::path_storage rect_path;
+      apply_clip_rect(rb_pre);
+      path_storage& rect_path = reset_path();
       rect_path.move_to(*x, *y);
       for (int i = 1; i < 4; i++) {
         rect_path.line_to(*(x+i),*(y+i));
@@ -231,12 +758,10 @@ namespace CPPAGGRenderer{
       rect_path.close_polygon();
       agg::trans_affine matrix;
       matrix *= agg::trans_affine_translation(0, 0);
-      agg::conv_transform<agg::path_storage, agg::trans_affine> trans(rect_path, matrix);
+      agg::conv_transform<path_storage, agg::trans_affine> trans(rect_path, matrix);
       if (hatch_pattern == 0) {
         Color c(r, g, b, a);
-        m_ras.add_path(trans);
-        ren_aa.color(c);
-        agg::render_scanlines(m_ras, m_sl_p8, ren_aa);
+        render_path(trans, rb, c);
       }
       else {
         generate_pattern(r, g, b, a, hatch_pattern);
@@ -259,34 +784,35 @@ namespace CPPAGGRenderer{
       agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
       pixfmt pixf = pixfmt(rbuf);
       renderer_base rb = renderer_base(pixf);
-      ren_aa = renderer_aa(rb);
-      agg::path_storage rect_path;
+      apply_clip_rect(rb);
+      attach_renderers(rb);
+      path_storage& rect_path = reset_path();
       rect_path.move_to(*x, *y);
       for (int i = 1; i < 4; i++) {
         rect_path.line_to(*(x+i),*(y+i));
       }
       rect_path.close_polygon();
-      agg::conv_stroke<agg::path_storage> rect_path_line(rect_path);
+      agg::conv_stroke<path_storage> rect_path_line(rect_path);
       agg::trans_affine matrix;
       matrix *= agg::trans_affine_translation(0, 0);
-      agg::conv_transform<agg::path_storage, agg::trans_affine> trans(rect_path, matrix);
-      agg::conv_curve<agg::conv_transform<agg::path_storage, agg::trans_affine>> curve(trans);
-      agg::conv_stroke<agg::conv_curve<agg::conv_transform<agg::path_storage, agg::trans_affine>>> stroke(curve);
+      agg::conv_transform<path_storage, agg::trans_affine> trans(rect_path, matrix);
+      agg::conv_curve<agg::conv_transform<path_storage, agg::trans_affine>> curve(trans);
+      agg::conv_stroke<agg::conv_curve<agg::conv_transform<path_storage, agg::trans_affine>>> stroke(curve);
       stroke.width(thickness);
-      m_ras.add_path(stroke);
       Color c(r, g, b, a);
-      ren_aa.color(c);
-      agg::render_scanlines(m_ras, m_sl_p8, ren_aa);
+      render_path(stroke, rb, c);
     }
 
     void draw_solid_rect_with_border(const float *x, const float *y, float thickness, float r_fill, float g_fill, float b_fill, float a_fill, float r_stroke, float g_stroke, float b_stroke, float a_stroke){
       agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
       pixfmt pixf = pixfmt(rbuf);
       renderer_base rb = renderer_base(pixf);
-      ren_aa = renderer_aa(rb);
+      apply_clip_rect(rb);
+      attach_renderers(rb);
       pixfmt_pre pixf_pre(rbuf);
       renderer_base_pre rb_pre(pixf_pre);
-      agg::path_storage rect_path;
+      apply_clip_rect(rb_pre);
+      path_storage& rect_path = reset_path();
       rect_path.move_to(*x, *y);
       for (int i = 1; i < 4; i++) {
         rect_path.line_to(*(x+i),*(y+i));
@@ -294,18 +820,14 @@ namespace CPPAGGRenderer{
       rect_path.close_polygon();
       agg::trans_affine matrix;
       matrix *= agg::trans_affine_translation(0, 0);
-      agg::conv_transform<agg::path_storage, agg::trans_affine> trans(rect_path, matrix);
+      agg::conv_transform<path_storage, agg::trans_affine> trans(rect_path, matrix);
       Color c1(r_fill, g_fill, b_fill, a_fill);
-      m_ras.add_path(trans);
-      ren_aa.color(c1);
-      agg::render_scanlines(m_ras, m_sl_p8, ren_aa);
-      agg::conv_curve<agg::conv_transform<agg::path_storage, agg::trans_affine>> curve(trans);
-      agg::conv_stroke<agg::conv_curve<agg::conv_transform<agg::path_storage, agg::trans_affine>>> stroke(curve);
+      render_path(trans, rb, c1);
+      agg::conv_curve<agg::conv_transform<path_storage, agg::trans_affine>> curve(trans);
+      agg::conv_stroke<agg::conv_curve<agg::conv_transform<path_storage, agg::trans_affine>>> stroke(curve);
       stroke.width(thickness);
-      m_ras.add_path(stroke);
       Color c2(r_stroke, g_stroke, b_stroke, a_stroke);
-      ren_aa.color(c2);
-      agg::render_scanlines(m_ras, m_sl_p8, ren_aa);
+      render_path(stroke, rb, c2);
 
     }
 
@@ -313,57 +835,61 @@ namespace CPPAGGRenderer{
       agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
       pixfmt pixf = pixfmt(rbuf);
       renderer_base rb = renderer_base(pixf);
-      ren_aa = renderer_aa(rb);
-      agg::ellipse circle(cx, cy, radius, radius, 100);
+      apply_clip_rect(rb);
+      attach_renderers(rb);
+      agg::ellipse circle(cx, cy, radius, radius, ellipse_steps(radius, radius));
       Color c(r, g, b, a);
       agg::trans_affine matrix;
       matrix *= agg::trans_affine_translation(0, 0);
       agg::conv_transform<agg::ellipse, agg::trans_affine> trans(circle, matrix);
       m_ras.add_path(trans);
       ren_aa.color(c);
-      agg::render_scanlines(m_ras, m_sl_p8, ren_aa);
+      render_solid();
     }
 
     void draw_solid_ellipse(float cx, float cy, float rx, float ry, float r, float g, float b, float a) {
       agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
       pixfmt pixf = pixfmt(rbuf);
       renderer_base rb = renderer_base(pixf);
-      ren_aa = renderer_aa(rb);
-      agg::ellipse ellipse(cx, cy, rx, ry, 100);
+      apply_clip_rect(rb);
+      attach_renderers(rb);
+      agg::ellipse ellipse(cx, cy, rx, ry, ellipse_steps(rx, ry));
       Color c(r, g, b, a);
       agg::trans_affine matrix;
       matrix *= agg::trans_affine_translation(0, 0);
       agg::conv_transform<agg::ellipse, agg::trans_affine> trans(ellipse, matrix);
       m_ras.add_path(trans);
       ren_aa.color(c);
-      agg::render_scanlines(m_ras, m_sl_p8, ren_aa);
+      render_solid();
     }
 
     void draw_solid_triangle(float x1, float x2, float x3, float y1, float y2, float y3, float r, float g, float b, float a) {
       agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
       pixfmt pixf = pixfmt(rbuf);
       renderer_base rb = renderer_base(pixf);
-      ren_aa = renderer_aa(rb);
-      agg::path_storage tri_path;
+      apply_clip_rect(rb);
+      attach_renderers(rb);
+      path_storage& tri_path = reset_path();
       tri_path.move_to(x1, y1);
       tri_path.line_to(x2, y2);
       tri_path.line_to(x3, y3);
       tri_path.close_polygon();
       agg::trans_affine matrix;
       matrix *= agg::trans_affine_translation(0, 0);
-      agg::conv_transform<agg::path_storage, agg::trans_affine> trans(tri_path, matrix);
+      agg::conv_transform<path_storage, agg::trans_affine> trans(tri_path, matrix);
       m_ras.add_path(trans);
       Color c(r, g, b, a);
       ren_aa.color(c);
-      agg::render_scanlines(m_ras, m_sl_p8, ren_aa);
+      render_solid();
     }
 
     void draw_solid_polygon(const float* x, const float* y, int count, float r, float g, float b, float a) {
       agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
       pixfmt pixf = pixfmt(rbuf);
       renderer_base rb = renderer_base(pixf);
-      ren_aa = renderer_aa(rb);
-      agg::path_storage poly_path;
+      apply_clip_rect(rb);
+      attach_renderers(rb);
+      path_storage& poly_path = reset_path();
       poly_path.move_to(*x, *y);
       for (int i = 1; i < count; i++) {
         poly_path.line_to(*(x+i),*(y+i));
@@ -371,142 +897,587 @@ namespace CPPAGGRenderer{
       poly_path.close_polygon();
       agg::trans_affine matrix;
       matrix *= agg::trans_affine_translation(0, 0);
-      agg::conv_transform<agg::path_storage, agg::trans_affine> trans(poly_path, matrix);
+      agg::conv_transform<path_storage, agg::trans_affine> trans(poly_path, matrix);
       m_ras.add_path(trans);
       Color c(r, g, b, a);
       ren_aa.color(c);
-      agg::render_scanlines(m_ras, m_sl_p8, ren_aa);
+      render_solid();
+    }
+
+    // Fills count polygons in a single pass. Polygon i has counts[i] vertices and is filled
+    // with the style styles[i], whose color is colors[4*styles[i]]...colors[4*styles[i]+3].
+    // Where polygons overlap, the higher style is drawn on top. Coverage is shared out
+    // between the styles in each pixel, so edges which polygons have in common, such as
+    // those between the segments of a stacked bar, are drawn without seams.
+    void draw_compound_polygons(const float* x, const float* y, const int* counts, const int* styles, int count, const float* colors, int style_count){
+      agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
+      pixfmt_pre pixf_pre(rbuf);
+      renderer_base_pre rb_pre(pixf_pre);
+      apply_clip_rect(rb_pre);
+      compound_styles.colors.resize(style_count);
+      for (int i = 0; i < style_count; i++) {
+        const float* rgba = colors + 4*i;
+        compound_styles.colors[i] = color_type(Color(rgba[0], rgba[1], rgba[2], rgba[3])).premultiply();
+      }
+      m_ras_compound.reset();
+      m_ras_compound.clip_box(0, 0, frame_width, frame_height);
+      path_storage& poly_path = reset_path();
+      int first = 0;
+      for (int i = 0; i < count; first += std::max(counts[i], 0), i++) {
+        if (counts[i] < 3 || styles[i] < 0 || styles[i] >= style_count)
+          continue;
+        poly_path.remove_all();
+        poly_path.move_to(x[first], y[first]);
+        for (int j = 1; j < counts[i]; j++) {
+          poly_path.line_to(x[first+j], y[first+j]);
+        }
+        poly_path.close_polygon();
+        m_ras_compound.styles(styles[i], -1);
+        m_ras_compound.add_path(poly_path);
+      }
+      agg::render_scanlines_compound_layered(m_ras_compound, m_sl_u8, rb_pre, m_compound_alloc, compound_styles);
+    }
+
+    // Draws an image of width by height pixels, stored as rows of unpremultiplied RGBA bytes
+    // with the bottom row first, scaled to fill the rect at (x, y) of size w by h. Each
+    // pixel of the frame takes the image pixel under its centre.
+    void draw_image(const unsigned char *rgba, int width, int height, float x, float y, float w, float h){
+      if (width <= 0 || height <= 0 || w <= 0 || h <= 0) return;
+      agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
+      pixfmt pixf = pixfmt(rbuf);
+      renderer_base rb = renderer_base(pixf);
+      apply_clip_rect(rb);
+      agg::rendering_buffer image_rbuf(const_cast<agg::int8u*>(rgba), width, height, width*4);
+      agg::pixfmt_rgba32 image_pixf(image_rbuf);
+      typedef agg::image_accessor_clone<agg::pixfmt_rgba32> img_source_type;
+      typedef agg::span_interpolator_linear<> interpolator_type;
+      typedef agg::span_image_filter_rgba_nn<img_source_type, interpolator_type> span_gen_type;
+      img_source_type img_src(image_pixf);
+      agg::trans_affine image_to_frame = agg::trans_affine_scaling(double(w) / width, double(h) / height);
+      image_to_frame *= agg::trans_affine_translation(x, y);
+      agg::trans_affine frame_to_image = image_to_frame;
+      frame_to_image.invert();
+      interpolator_type interpolator(frame_to_image);
+      span_gen_type sg(img_src, interpolator);
+      agg::span_allocator<color_type> sa;
+      path_storage& rect_path = reset_path();
+      rect_path.move_to(x, y);
+      rect_path.line_to(x + w, y);
+      rect_path.line_to(x + w, y + h);
+      rect_path.line_to(x, y + h);
+      rect_path.close_polygon();
+      m_ras.add_path(rect_path);
+      agg::render_scanlines_aa(m_ras, m_sl_p8, rb, sa, sg);
+    }
+
+    // Moves the whole pixels within the rect at (x, y) of size w by h by (dx, dy), rounded
+    // to whole pixels. Pixels moved outside the rect are dropped, and the part of the rect
+    // which nothing is moved into keeps its old pixels.
+    void move_region(float x, float y, float w, float h, float dx, float dy){
+      agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
+      int x1 = std::max(int(ceil(x)), 0), x2 = std::min(int(floor(x + w)), frame_width);
+      int y1 = std::max(int(ceil(y)), 0), y2 = std::min(int(floor(y + h)), frame_height);
+      int shift_x = int(floor(dx + 0.5)), shift_y = int(floor(dy + 0.5));
+      int to_x1 = std::max(x1, x1 + shift_x), to_x2 = std::min(x2, x2 + shift_x);
+      int to_y1 = std::max(y1, y1 + shift_y), to_y2 = std::min(y2, y2 + shift_y);
+      if (to_x1 >= to_x2 || to_y1 >= to_y2) return;
+      size_t row_bytes = size_t(to_x2 - to_x1) * 3;
+      // Rows are copied in the direction which reads each row before it is overwritten.
+      for (int i = 0; i < to_y2 - to_y1; i++) {
+        int to_y = shift_y > 0 ? to_y2 - 1 - i : to_y1 + i;
+        memmove(rbuf.row_ptr(to_y) + to_x1 * 3, rbuf.row_ptr(to_y - shift_y) + (to_x1 - shift_x) * 3, row_bytes);
+      }
+    }
+
+    // The whole pixels touched by the rect at (x, y) of size w by h, within the frame.
+    void layer_rect(float x, float y, float w, float h, int& x1, int& y1, int& x2, int& y2) const {
+      x1 = std::max(int(floor(x)), 0);
+      y1 = std::max(int(floor(y)), 0);
+      x2 = std::max(std::min(int(ceil(x + w)), frame_width), x1);
+      y2 = std::max(std::min(int(ceil(y + h)), frame_height), y1);
+    }
+
+    void read_region(const Layer& layer, std::vector<unsigned char>& pixels){
+      agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
+      size_t row_bytes = size_t(layer.x2 - layer.x1) * 3;
+      pixels.resize(row_bytes * (layer.y2 - layer.y1));
+      for (int y = layer.y1; y < layer.y2; y++)
+        memcpy(&pixels[row_bytes * (y - layer.y1)], rbuf.row_ptr(y) + layer.x1 * 3, row_bytes);
+    }
+
+    void write_region(const Layer& layer, const std::vector<unsigned char>& pixels){
+      agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
+      size_t row_bytes = size_t(layer.x2 - layer.x1) * 3;
+      for (int y = layer.y1; y < layer.y2; y++)
+        memcpy(rbuf.row_ptr(y) + layer.x1 * 3, &pixels[row_bytes * (y - layer.y1)], row_bytes);
+    }
+
+    void fill_region(const Layer& layer, unsigned char value){
+      agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
+      for (int y = layer.y1; y < layer.y2; y++)
+        memset(rbuf.row_ptr(y) + layer.x1 * 3, value, size_t(layer.x2 - layer.x1) * 3);
+    }
+
+    void composite_layer(const Layer& layer){
+      if (!layer.overlay) {
+        write_region(layer, layer.base);
+        return;
+      }
+      agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
+      size_t row_bytes = size_t(layer.x2 - layer.x1) * 3;
+      for (int y = layer.y1; y < layer.y2; y++) {
+        unsigned char* p = rbuf.row_ptr(y) + layer.x1 * 3;
+        const unsigned char* base = &layer.base[row_bytes * (y - layer.y1)];
+        const unsigned char* scale = &layer.scale[row_bytes * (y - layer.y1)];
+        for (size_t i = 0; i < row_bytes; i++) {
+          // Most of an overlay, outside the shapes it draws, leaves the pixels alone.
+          if (scale[i] != 255)
+            p[i] = base[i] + (scale[i] * p[i] + 127) / 255;
+        }
+      }
+    }
+
+    // Draws the layer kept for key, if there is one for the same pixels.
+    bool draw_layer(long long key, float x, float y, float w, float h){
+      int x1, y1, x2, y2;
+      layer_rect(x, y, w, h, x1, y1, x2, y2);
+      for (size_t i = 0; i < layers.size(); i++) {
+        const Layer& layer = layers[i];
+        if (layer.key != key || layer.x1 != x1 || layer.y1 != y1 || layer.x2 != x2 || layer.y2 != y2)
+          continue;
+        std::rotate(layers.begin() + i, layers.begin() + i + 1, layers.end());
+        composite_layer(layers.back());
+        return true;
+      }
+      return false;
+    }
+
+    // Starts drawing a layer to keep for key. An overlay is drawn twice, first over black and
+    // then, after next_layer_pass, over white.
+    void begin_layer(long long key, float x, float y, float w, float h, bool overlay){
+      pending_layer.key = key;
+      layer_rect(x, y, w, h, pending_layer.x1, pending_layer.y1, pending_layer.x2, pending_layer.y2);
+      pending_layer.overlay = overlay;
+      if (overlay) {
+        read_region(pending_layer, pending_under);
+        fill_region(pending_layer, 0);
+      }
+    }
+
+    void next_layer_pass(){
+      read_region(pending_layer, pending_layer.base);
+      fill_region(pending_layer, 255);
+    }
+
+    // Keeps the layer drawn since begin_layer, and draws an overlay over the pixels beneath it.
+    void end_layer(){
+      Layer layer = pending_layer;
+      if (layer.overlay) {
+        read_region(layer, layer.scale);
+        for (size_t i = 0; i < layer.scale.size(); i++)
+          layer.scale[i] = layer.scale[i] > layer.base[i] ? layer.scale[i] - layer.base[i] : 0;
+        write_region(layer, pending_under);
+        composite_layer(layer);
+      } else {
+        read_region(layer, layer.base);
+      }
+      for (size_t i = 0; i < layers.size(); i++) {
+        if (layers[i].key == layer.key) {
+          layers.erase(layers.begin() + i);
+          break;
+        }
+      }
+      if (layers.size() >= max_layers)
+        layers.erase(layers.begin());
+      layers.push_back(layer);
+    }
+
+    void clear_layers(){
+      layers.clear();
     }
 
     void draw_line(const float *x, const float *y, float thickness, float r, float g, float b, float a, bool is_dashed){
       agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
       pixfmt pixf = pixfmt(rbuf);
       renderer_base rb = renderer_base(pixf);
-      ren_aa = renderer_aa(rb);
-      agg::path_storage rect_path;
-      rect_path.move_to(*x, *y);
-      rect_path.line_to(*(x+1),*(y+1));
+      apply_clip_rect(rb);
+      attach_renderers(rb);
+      double x1 = x[0], y1 = y[0], x2 = x[1], y2 = y[1];
+      unsigned clipped = agg::clip_line_segment(&x1, &y1, &x2, &y2, visible_box(2.0 * thickness + 2));
+      if (clipped >= 4)
+        return;
+      // Only lines too long to rasterize whole are shortened, as cutting a line moves its
+      // edges slightly. Dashes are laid out along the stroke's outline, so dashed lines
+      // are never shortened.
+      if (is_dashed || segment_cells(x[0], y[0], x[1], y[1], thickness, false) <= polyline_chunk_cells) {
+        x1 = x[0]; y1 = y[0]; x2 = x[1]; y2 = y[1];
+      }
+      path_storage& rect_path = reset_path();
+      rect_path.move_to(x1, y1);
+      rect_path.line_to(x2, y2);
 
       agg::trans_affine matrix;
       matrix *= agg::trans_affine_translation(0, 0);
-      agg::conv_transform<agg::path_storage, agg::trans_affine> trans(rect_path, matrix);
-      agg::conv_curve<agg::conv_transform<agg::path_storage, agg::trans_affine>> curve(trans);
-      agg::conv_stroke<agg::conv_curve<agg::conv_transform<agg::path_storage, agg::trans_affine>>> stroke(curve);
+      agg::conv_transform<path_storage, agg::trans_affine> trans(rect_path, matrix);
+      agg::conv_curve<agg::conv_transform<path_storage, agg::trans_affine>> curve(trans);
+      agg::conv_stroke<agg::conv_curve<agg::conv_transform<path_storage, agg::trans_affine>>> stroke(curve);
       stroke.width(thickness);
+      Color c(r, g, b, a);
       if (is_dashed) {
-        agg::conv_dash<agg::conv_stroke<agg::conv_curve<agg::conv_transform<agg::path_storage, agg::trans_affine>>>> poly2_dash(stroke);
-        agg::conv_stroke<agg::conv_dash<agg::conv_stroke<agg::conv_curve<agg::conv_transform<agg::path_storage, agg::trans_affine>>>>> poly2(poly2_dash);
+        agg::conv_dash<agg::conv_stroke<agg::conv_curve<agg::conv_transform<path_storage, agg::trans_affine>>>> poly2_dash(stroke);
+        agg::conv_stroke<agg::conv_dash<agg::conv_stroke<agg::conv_curve<agg::conv_transform<path_storage, agg::trans_affine>>>>> poly2(poly2_dash);
         poly2.width(thickness);
         poly2_dash.add_dash(thickness + 1, thickness + 1);
         poly2.line_cap(buttCap);
-        m_ras.add_path(poly2);
+        render_path(poly2, rb, c);
       }
       else {
-        m_ras.add_path(stroke);
+        render_path(stroke, rb, c);
       }
-      Color c(r, g, b, a);
-      ren_aa.color(c);
-      agg::render_scanlines(m_ras, m_sl_p8, ren_aa);
     }
 
-    void draw_plot_lines(const float *x, const float *y, int size, float thickness, float r, float g, float b, float a, bool isDashed){
+    // Draws the polyline, returning false if any of it could not be rasterized.
+    //
+    // The rasterizer silently drops cells past its limit, and holds all the cells of a
+    // path at once. A polyline whose outline may need more than polyline_chunk_cells cells
+    // is split into pieces which are rasterized and drawn one after the other, so very
+    // long lines are drawn in full using a bounded amount of memory. Segments outside the
+    // visible box are left out before stroking, so off-screen parts of a line cost next
+    // to nothing.
+    bool draw_plot_lines(const float *x, const float *y, int size, float thickness, float r, float g, float b, float a, bool isDashed){
+      if (size < 1) return true;
       agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
       pixfmt pixf = pixfmt(rbuf);
       renderer_base rb = renderer_base(pixf);
-      ren_aa = renderer_aa(rb);
-      agg::path_storage rect_path;
-      rect_path.move_to(*x, *y);
+      apply_clip_rect(rb);
+      attach_renderers(rb);
+      Color c(r, g, b, a);
+      ren_aa.color(c);
+      if (hairline_width > 0 && thickness > 0 && thickness <= hairline_width && draw_hairlines(rb, x, y, size, thickness, c, isDashed))
+        return true;
+
+      // Lines within the budget are drawn whole. Cutting them at the visible box moves
+      // their edges by a fraction of a subpixel, which can change the coverage of pixels
+      // inside it.
+      double total_cells = 0;
+      for (int i = 1; i < size && total_cells <= polyline_chunk_cells; i++) {
+        total_cells += segment_cells(x[i-1], y[i-1], x[i], y[i], thickness);
+      }
+      path_storage& line_path = reset_path();
+      if (total_cells <= polyline_chunk_cells) {
+        line_path.move_to(*x, *y);
+        for (int i = 1; i < size; i++) {
+          line_path.line_to(*(x+i),*(y+i));
+        }
+        add_plot_line_path(line_path, thickness, isDashed, 0);
+        render_solid();
+        return true;
+      }
+
+      // Miter joins reach up to twice the thickness from their point, so nothing outside
+      // this box can show. Outlines are clipped to the visible box, which bounds the cells
+      // used by each segment.
+      agg::rect_d box = visible_box(2.0 * thickness + 2);
+      agg::rect_d cell_box = visible_box(thickness + 2);
+      m_ras.clip_box(cell_box.x1, cell_box.y1, cell_box.x2, cell_box.y2);
+      bool complete = true;
+      double dash_period = 2 * (thickness + 1);
+      // The distance along the line to the start of the current segment and of the current
+      // piece, so that dashes carry on across pieces and gaps.
+      double distance = 0;
+      double piece_distance = 0;
+      // The cells added to the rasterizer since it was last swept.
+      double cells = 0;
+      bool piece_open = false;
       for (int i = 1; i < size; i++) {
-        rect_path.line_to(*(x+i),*(y+i));
+        double x1 = x[i-1], y1 = y[i-1], x2 = x[i], y2 = y[i];
+        double length = hypot(x2 - x1, y2 - y1);
+        unsigned clipped = agg::clip_line_segment(&x1, &y1, &x2, &y2, box);
+        if (clipped < 4) {
+          double segment = segment_cells(x1, y1, x2, y2, thickness);
+          if (segment > rasterizer_cell_limit) complete = false;
+          if (piece_open && (clipped & 1)) {
+            add_plot_line_path(line_path, thickness, isDashed, fmod(piece_distance, dash_period));
+            piece_open = false;
+          }
+          if (cells > 0 && cells + segment > polyline_chunk_cells) {
+            // Pieces are split halfway along a segment, so that no join is lost and the
+            // butt caps of adjoining pieces meet.
+            if (piece_open) {
+              double mid_x = (x1 + x2) / 2, mid_y = (y1 + y2) / 2;
+              line_path.line_to(mid_x, mid_y);
+              add_plot_line_path(line_path, thickness, isDashed, fmod(piece_distance, dash_period));
+              piece_open = false;
+              x1 = mid_x;
+              y1 = mid_y;
+              segment /= 2;
+            }
+            render_solid();
+            cells = 0;
+          }
+          if (!piece_open) {
+            line_path.remove_all();
+            line_path.move_to(x1, y1);
+            piece_distance = distance + hypot(x1 - x[i-1], y1 - y[i-1]);
+            piece_open = true;
+          }
+          line_path.line_to(x2, y2);
+          cells += segment;
+          // The line leaves the box; the next segment inside starts a new piece, which is
+          // swept together with this one.
+          if (clipped & 2) {
+            add_plot_line_path(line_path, thickness, isDashed, fmod(piece_distance, dash_period));
+            piece_open = false;
+          }
+        }
+        distance += length;
       }
+      if (piece_open)
+        add_plot_line_path(line_path, thickness, isDashed, fmod(piece_distance, dash_period));
+      render_solid();
+      m_ras.reset_clipping();
+      return complete;
+    }
+
+    // Draws a thin polyline directly with anti-aliased line segments, rather than filling
+    // its stroked outline, so no joins are computed and no cells are sorted. Points less
+    // than about 1.5 pixels apart are merged. Returns false, drawing nothing, if the line
+    // has coordinates too large for the renderer's fixed-point arithmetic.
+    bool draw_hairlines(renderer_base& rb, const float *x, const float *y, int size, float thickness, const Color& c, bool isDashed){
+      static const float max_coordinate = 1 << 20;
+      for (int i = 0; i < size; i++) {
+        if (!(fabs(x[i]) < max_coordinate && fabs(y[i]) < max_coordinate))
+          return false;
+      }
+      if (hairline_profile_width != thickness) {
+        hairline_profile.width(thickness);
+        hairline_profile_width = thickness;
+      }
+      renderer_outline ren(rb, hairline_profile);
+      ren.color(c);
+      agg::rect_d box = visible_box(thickness + 2);
+      ren.clip_box(box.x1, box.y1, box.x2, box.y2);
+      rasterizer_outline ras(ren);
+      polyline_arrays line(x, y, size);
+      if (isDashed) {
+        agg::conv_dash<polyline_arrays> dash(line);
+        dash.add_dash(thickness + 1, thickness + 1);
+        ras.add_path(dash);
+      }
+      else {
+        ras.add_path(line);
+      }
+      return true;
+    }
+
+    // Adds the stroked polyline to the rasterizer, with its dash pattern starting from
+    // the given offset.
+    void add_plot_line_path(path_storage& line_path, float thickness, bool isDashed, double dash_start){
       agg::trans_affine matrix;
-      agg::conv_transform<agg::path_storage, agg::trans_affine> trans(rect_path, matrix);
-      agg::conv_curve<agg::conv_transform<agg::path_storage, agg::trans_affine>> curve(trans);
-      agg::conv_stroke<agg::conv_curve<agg::conv_transform<agg::path_storage, agg::trans_affine>>> stroke(curve);
+      agg::conv_transform<path_storage, agg::trans_affine> trans(line_path, matrix);
+      agg::conv_curve<agg::conv_transform<path_storage, agg::trans_affine>> curve(trans);
+      agg::conv_stroke<agg::conv_curve<agg::conv_transform<path_storage, agg::trans_affine>>> stroke(curve);
       stroke.width(thickness);
       if (isDashed) {
-        agg::conv_dash<agg::conv_transform<agg::path_storage, agg::trans_affine>> poly2_dash(trans);
-        agg::conv_curve<agg::conv_dash<agg::conv_transform<agg::path_storage, agg::trans_affine>>> curve(poly2_dash);
-        agg::conv_stroke<agg::conv_curve<agg::conv_dash<agg::conv_transform<agg::path_storage, agg::trans_affine>>>> poly2(curve);
+        agg::conv_dash<agg::conv_transform<path_storage, agg::trans_affine>> poly2_dash(trans);
+        agg::conv_curve<agg::conv_dash<agg::conv_transform<path_storage, agg::trans_affine>>> curve(poly2_dash);
+        agg::conv_stroke<agg::conv_curve<agg::conv_dash<agg::conv_transform<path_storage, agg::trans_affine>>>> poly2(curve);
         poly2.width(thickness);
         poly2_dash.add_dash(thickness + 1, thickness + 1);
+        poly2_dash.dash_start(dash_start);
         poly2.line_cap(buttCap);
         m_ras.add_path(poly2);
       }
       else {
         m_ras.add_path(stroke);
       }
-      Color c(r, g, b, a);
-      ren_aa.color(c);
-      agg::render_scanlines(m_ras, m_sl_p8, ren_aa);
     }
 
-    void draw_text(const char *s, float x, float y, float size, float r, float g, float b, float a, float thickness, float angle){
+    // An upper bound on the number of cells added to the rasterizer by the stroked outline
+    // of a segment, once clipped to the frame unless clipped is false. Each edge of the
+    // outline adds about one cell per pixel it crosses, and joins add a few more.
+    double segment_cells(double x1, double y1, double x2, double y2, float thickness, bool clipped = true){
+      double extent = fabs(x2 - x1) + fabs(y2 - y1);
+      double clipped_extent = 2.0 * (frame_width + frame_height) + 8.0 * (thickness + 2);
+      return 2 * (clipped ? std::min(extent, clipped_extent) : extent) + 16.0 * (thickness + 1) + 8;
+    }
+
+    // Loads the font at the given size, rotated by the given angle in degrees.
+    bool select_font(float size, float angle, agg::glyph_rendering rendering){
+      font_width = font_height = size;
+      m_contour.width(-font_weight*font_height*0.05);
+      // Reloading the font is costly, and unnecessary when drawing many labels alike.
+      if(font_selected && selected_height == font_height && selected_angle == angle &&
+         selected_rendering == rendering)
+        return true;
+      font_selected = false;
+      agg::trans_affine matrix;
+      matrix *= agg::trans_affine_rotation(agg::deg2rad(angle));
+      m_feng.transform(matrix);
+      bool loaded = font_data && !font_data->empty() ?
+        m_feng.load_font(fontPath.c_str(), 0, rendering, font_data->data(), font_data->size()) :
+        m_feng.load_font(fontPath.c_str(), 0, rendering);
+      if(!loaded)
+        return false;
+      m_feng.hinting(font_hinting || quality == quality_draft);
+      m_feng.height(font_height);
+      m_feng.width(font_width);
+      m_feng.flip_y(false);
+      font_selected = true;
+      selected_height = font_height;
+      selected_angle = angle;
+      selected_rendering = rendering;
+      return true;
+    }
+
+    TextRun* create_text_run(const char *s, float size){
+      TextRun *run = new TextRun();
+      std::vector<unsigned> codes = decode_utf8(s);
+      run->size = size;
+      run->kerning = font_kerning;
+      float x = 0;
+      float maxY = 0;
+      float minY = 0;
+      if(select_font(size, 0, text_rendering(0))){
+        m_fman.reset_last_glyph();
+        run->codes.reserve(codes.size());
+        run->positions.reserve(codes.size());
+        for(size_t i = 0; i < codes.size(); i++){
+          const agg::glyph_cache* glyph = m_fman.glyph(codes[i]);
+          if(glyph){
+            if(run->kerning){
+              double dx = double(x);
+              double dy = 0;
+              m_fman.add_kerning(&dx, &dy);
+              x = dx;
+            }
+            run->codes.push_back(codes[i]);
+            run->positions.push_back(x);
+            x+=glyph->advance_x;
+            maxY = max(maxY, (float)glyph->bounds.y2);
+            minY = min(minY, (float)glyph->bounds.y1);
+          }
+        }
+      }
+      run->width = x;
+      run->height = abs(maxY - minY);
+      return run;
+    }
+
+    void draw_text_run(const TextRun *run, float x, float y, float r, float g, float b, float a, float thickness, float angle){
       agg::rendering_buffer rbuf = agg::rendering_buffer(buffer, frame_width, frame_height, -frame_width*3);
       pixfmt pixf = pixfmt(rbuf);
       renderer_base rb = renderer_base(pixf);
-      ren_aa = renderer_aa(rb);
-      font_width = font_height = size;
+      apply_clip_rect(rb);
+      attach_renderers(rb);
       font_weight = thickness;
       Color color(r, g, b, a);
-      m_contour.width(-font_weight*font_height*0.05);
-      if(m_feng.load_font(fontPath.c_str(), 0, gren)){
-      // if(m_feng.load_font(0, gren, roboto, roboto_size)){
-        m_feng.hinting(font_hinting);
-        m_feng.height(font_height);
-        m_feng.width(font_width);
-        m_feng.flip_y(false);
-        agg::trans_affine matrix;
-        matrix *= agg::trans_affine_rotation(agg::deg2rad(angle));
-        m_feng.transform(matrix);
-        while(*s){
-          const agg::glyph_cache* glyph = m_fman.glyph(*s);
+      if(glyph_atlas_enabled && angle == 0 && quality != quality_draft){
+        draw_text_run_from_atlas(run, x, y, color, rb);
+        return;
+      }
+      if(select_font(run->size, angle, text_rendering(angle))){
+        m_fman.reset_last_glyph();
+        ren_aa.color(color);
+        for(size_t i = 0; i < run->codes.size(); i++){
+          const agg::glyph_cache* glyph = m_fman.glyph(run->codes[i]);
           if(glyph){
-            if(font_kerning){
+            if(run->kerning){
               double dx = double(x);
               double dy = double(y);
               m_fman.add_kerning(&dx, &dy);
+              x = dx;
+              y = dy;
             }
             m_fman.init_embedded_adaptors(glyph, x, y);
-            ren_aa.color(color);
             agg::render_scanlines(m_fman.gray8_adaptor(), m_fman.gray8_scanline(), ren_aa);
             x+=glyph->advance_x;
             y+=glyph->advance_y;
           }
-          ++s;
         }
       }
     }
 
-    void get_text_size(const char *s, float size, float* outW, float* outH){
-      font_width = font_height = size;
-      m_contour.width(-font_weight*font_height*0.05);
-      float x = 0;
-      float maxY = 0;
-      float minY = 0;
-      // set rotation of font engine to zero before calculating text width
-      agg::trans_affine matrix;
-      matrix *= agg::trans_affine_rotation(agg::deg2rad(0));
-      m_feng.transform(matrix);
-      if(m_feng.load_font(fontPath.c_str(), 0, gren)){
-        m_feng.hinting(font_hinting);
-        m_feng.height(font_height);
-        m_feng.width(font_width);
-        m_feng.flip_y(false);
-        while(*s){
-          const agg::glyph_cache* glyph = m_fman.glyph(*s);
-          if(glyph){
-            x+=glyph->advance_x;
-            maxY = max(maxY, (float)glyph->bounds.y2);
-            minY = min(minY, (float)glyph->bounds.y1);
-          }
-          ++s;
+    // Draws unrotated text from the glyph atlas, positioned to a quarter of a pixel.
+    void draw_text_run_from_atlas(const TextRun *run, float x, float y, const Color& color, renderer_base& rb){
+      const agg::rgba8 color8(color);
+      const int pen_y = agg::iround(y);
+      for(size_t i = 0; i < run->codes.size(); i++){
+        double pen_x = double(x) + run->positions[i];
+        int pixel_x = int(floor(pen_x));
+        int subpixel = agg::iround((pen_x - pixel_x) * GlyphAtlas::subpixel_steps);
+        if(subpixel == GlyphAtlas::subpixel_steps){
+          pixel_x++;
+          subpixel = 0;
         }
+        const GlyphAtlas::Glyph* glyph = atlas_glyph(run->codes[i], run->size, subpixel);
+        if(glyph)
+          glyph_atlas.blend(rb, *glyph, pixel_x, pen_y, color8);
       }
-        if (outW)
-            *outW = x;
-        if (outH)
-          *outH = abs(maxY - minY);
+    }
+
+    // Returns the atlas mask of the glyph, rasterizing its outline if it is not in the atlas.
+    const GlyphAtlas::Glyph* atlas_glyph(unsigned code, float size, int subpixel){
+      const GlyphAtlas::Glyph* glyph = glyph_atlas.find(code, size, subpixel);
+      if(glyph)
+        return glyph;
+      if(!select_font(size, 0, agg::glyph_ren_outline))
+        return 0;
+      const agg::glyph_cache* outline = m_fman.glyph(code);
+      if(!outline)
+        return 0;
+      m_ras.reset();
+      m_fman.init_embedded_adaptors(outline, double(subpixel) / GlyphAtlas::subpixel_steps, 0);
+      m_ras.add_path(m_curves);
+      return glyph_atlas.insert(code, size, subpixel, m_ras);
+    }
+
+    void draw_text(const char *s, float x, float y, float size, float r, float g, float b, float a, float thickness, float angle){
+      TextRun *run = create_text_run(s, size);
+      draw_text_run(run, x, y, r, g, b, a, thickness, angle);
+      delete run;
+    }
+
+    void get_text_size(const char *s, float size, float* outW, float* outH){
+      TextRun *run = create_text_run(s, size);
+      if (outW)
+          *outW = run->width;
+      if (outH)
+          *outH = run->height;
+      delete run;
+    }
+
+    void set_text_kerning(bool enabled){
+      font_kerning = enabled;
+    }
+
+    void set_glyph_atlas(bool enabled){
+      glyph_atlas_enabled = enabled;
+    }
+
+    void set_hairline_width(float width){
+      hairline_width = width;
+    }
+
+    void set_render_quality(int new_quality){
+      quality = std::min(std::max(new_quality, int(quality_draft)), int(quality_high));
+      approximation_scale = quality == quality_draft ? 0.5 : quality == quality_high ? 8.0 : 2.0;
+      m_curves.approximation_scale(approximation_scale);
+      if(quality == quality_draft)
+        m_ras.gamma(agg::gamma_threshold(0.5));
+      else
+        m_ras.gamma(agg::gamma_none());
+      // Hinting depends on the quality, so the font must be loaded again.
+      font_selected = false;
+    }
+
+    void set_clip_rect(float x, float y, float width, float height){
+      clip_rect = agg::rect_d(x, y, x + width, y + height).normalize();
+      clip_rect_enabled = true;
+    }
+
+    void reset_clip_rect(){
+      clip_rect_enabled = false;
     }
 
     unsigned save_image(const char *s, const char** errorDesc){
@@ -534,6 +1505,11 @@ namespace CPPAGGRenderer{
     object = 0;
   }
 
+  void reset_plot(float w, float h, const void *object){
+    Plot *plot = (Plot *)object;
+    plot->reset(w, h);
+  }
+
   void draw_rect(const float *x, const float *y, float thickness, float r, float g, float b, float a,
                  const void *object){
     Plot *plot = (Plot *)object;
@@ -570,14 +1546,54 @@ namespace CPPAGGRenderer{
     plot -> draw_solid_polygon(x, y, count, r, g, b, a);
   }
 
+  void draw_compound_polygons(const float* x, const float* y, const int* counts, const int* styles, int count, const float* colors, int style_count, const void *object){
+    Plot *plot = (Plot *)object;
+    plot -> draw_compound_polygons(x, y, counts, styles, count, colors, style_count);
+  }
+
+  void draw_image(const unsigned char *rgba, int width, int height, float x, float y, float w, float h, const void *object){
+    Plot *plot = (Plot *)object;
+    plot -> draw_image(rgba, width, height, x, y, w, h);
+  }
+
+  void move_region(float x, float y, float w, float h, float dx, float dy, const void *object){
+    Plot *plot = (Plot *)object;
+    plot -> move_region(x, y, w, h, dx, dy);
+  }
+
+  bool draw_layer(long long key, float x, float y, float w, float h, const void *object){
+    Plot *plot = (Plot *)object;
+    return plot -> draw_layer(key, x, y, w, h);
+  }
+
+  void begin_layer(long long key, float x, float y, float w, float h, bool overlay, const void *object){
+    Plot *plot = (Plot *)object;
+    plot -> begin_layer(key, x, y, w, h, overlay);
+  }
+
+  void next_layer_pass(const void *object){
+    Plot *plot = (Plot *)object;
+    plot -> next_layer_pass();
+  }
+
+  void end_layer(const void *object){
+    Plot *plot = (Plot *)object;
+    plot -> end_layer();
+  }
+
+  void clear_layers(const void *object){
+    Plot *plot = (Plot *)object;
+    plot -> clear_layers();
+  }
+
   void draw_line(const float *x, const float *y, float thickness, float r, float g, float b, float a, bool is_dashed, const void *object){
     Plot *plot = (Plot *)object;
     plot -> draw_line(x, y, thickness, r, g, b, a, is_dashed);
   }
 
-  void draw_plot_lines(const float *x, const float *y, int size, float thickness, float r, float g, float b, float a, bool isDashed, const void *object){
+  bool draw_plot_lines(const float *x, const float *y, int size, float thickness, float r, float g, float b, float a, bool isDashed, const void *object){
     Plot *plot = (Plot *)object;
-    plot -> draw_plot_lines(x, y, size, thickness, r, g, b, a, isDashed);
+    return plot -> draw_plot_lines(x, y, size, thickness, r, g, b, a, isDashed);
   }
 
   void draw_text(const char *s, float x, float y, float size, float r, float g, float b, float a, float thickness, float angle, const void *object){
@@ -590,6 +1606,59 @@ namespace CPPAGGRenderer{
     plot -> get_text_size(s, size, outW, outH);
   }
 
+  void * create_text_run(const char *s, float size, const void *object){
+    Plot *plot = (Plot *)object;
+    return (void *)plot -> create_text_run(s, size);
+  }
+
+  void get_text_run_size(const void *run, float* outW, float* outH){
+    const TextRun *text_run = (const TextRun *)run;
+    if (outW)
+        *outW = text_run -> width;
+    if (outH)
+        *outH = text_run -> height;
+  }
+
+  void draw_text_run(const void *run, float x, float y, float r, float g, float b, float a, float thickness, float angle, const void *object){
+    Plot *plot = (Plot *)object;
+    plot -> draw_text_run((const TextRun *)run, x, y, r, g, b, a, thickness, angle);
+  }
+
+  void delete_text_run(void *run){
+    TextRun *text_run = (TextRun *)run;
+    delete text_run;
+  }
+
+  void set_text_kerning(bool enabled, const void *object){
+    Plot *plot = (Plot *)object;
+    plot -> set_text_kerning(enabled);
+  }
+
+  void set_glyph_atlas(bool enabled, const void *object){
+    Plot *plot = (Plot *)object;
+    plot -> set_glyph_atlas(enabled);
+  }
+
+  void set_hairline_width(float width, const void *object){
+    Plot *plot = (Plot *)object;
+    plot -> set_hairline_width(width);
+  }
+
+  void set_render_quality(int quality, const void *object){
+    Plot *plot = (Plot *)object;
+    plot -> set_render_quality(quality);
+  }
+
+  void set_clip_rect(float x, float y, float width, float height, const void *object){
+    Plot *plot = (Plot *)object;
+    plot -> set_clip_rect(x, y, width, height);
+  }
+
+  void reset_clip_rect(const void *object){
+    Plot *plot = (Plot *)object;
+    plot -> reset_clip_rect();
+  }
+
   unsigned save_image(const char *s, const char** errorDesc, const void *object){
     Plot *plot = (Plot *)object;
     return plot -> save_image(s, errorDesc);
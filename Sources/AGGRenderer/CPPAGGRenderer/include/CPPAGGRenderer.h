@@ -6,6 +6,8 @@ namespace CPPAGGRenderer{
 
   void delete_plot(void *object);
 
+  void reset_plot(float w, float h, const void *object);
+
   void draw_rect(const float *x, const float *y, float thickness, float r, float g, float b, float a, const void *object);
 
   void draw_solid_rect(const float *x, const float *y, float r, float g, float b, float a, int hatch_pattern, const void *object);
@@ -20,14 +22,50 @@ namespace CPPAGGRenderer{
 
   void draw_solid_polygon(const float* x, const float* y, int count, float r, float g, float b, float a, const void *object);
 
+  void draw_compound_polygons(const float* x, const float* y, const int* counts, const int* styles, int count, const float* colors, int style_count, const void *object);
+
+  void draw_image(const unsigned char *rgba, int width, int height, float x, float y, float w, float h, const void *object);
+
+  void move_region(float x, float y, float w, float h, float dx, float dy, const void *object);
+
+  bool draw_layer(long long key, float x, float y, float w, float h, const void *object);
+
+  void begin_layer(long long key, float x, float y, float w, float h, bool overlay, const void *object);
+
+  void next_layer_pass(const void *object);
+
+  void end_layer(const void *object);
+
+  void clear_layers(const void *object);
+
   void draw_line(const float *x, const float *y, float thickness, float r, float g, float b, float a, bool is_dashed, const void *object);
 
-  void draw_plot_lines(const float *x, const float *y, int size, float thickness, float r, float g, float b, float a, bool isDashed, const void *object);
+  bool draw_plot_lines(const float *x, const float *y, int size, float thickness, float r, float g, float b, float a, bool isDashed, const void *object);
 
   void draw_text(const char *s, float x, float y, float size, float r, float g, float b, float a, float thickness, float angle, const void *object);
 
   void get_text_size(const char *s, float size, float* outW, float* outH, const void *object);
 
+  void * create_text_run(const char *s, float size, const void *object);
+
+  void get_text_run_size(const void *run, float* outW, float* outH);
+
+  void draw_text_run(const void *run, float x, float y, float r, float g, float b, float a, float thickness, float angle, const void *object);
+
+  void delete_text_run(void *run);
+
+  void set_text_kerning(bool enabled, const void *object);
+
+  void set_glyph_atlas(bool enabled, const void *object);
+
+  void set_hairline_width(float width, const void *object);
+
+  void set_render_quality(int quality, const void *object);
+
+  void set_clip_rect(float x, float y, float width, float height, const void *object);
+
+  void reset_clip_rect(const void *object);
+
   unsigned save_image(const char *s, const char** errorDesc, const void *object);
 
   unsigned create_png_buffer(unsigned char **output, size_t *outputSize, const char **errorDesc, const void *object);
@@ -29,9 +29,9 @@ typedef agg::order_bgr component_order;
 
 #elif defined(AGG_RGB24)
 
-#include "agg_pixfmt_rgb.h"
+#include "span_blend.h"
 #define pix_format agg::pix_format_rgb24
-typedef agg::pixfmt_rgb24 pixfmt;
+typedef span_blend::pixfmt_rgb24<agg::order_rgb> pixfmt;
 typedef agg::pixfmt_rgb24_pre pixfmt_pre;
 #define pixfmt_gamma agg::pixfmt_rgb24_gamma
 typedef agg::rgba8 color_type;
@@ -3,50 +3,16 @@
 #include <cstring>
 using namespace std;
 
-int w = 1000;
-int h = 660;
+// Writes an RGB buffer, with rows from the top down, as a 24-bit BMP file.
+// All state is local, so this may be called from several threads at once.
+inline void saveBMP(const unsigned char* buf, float width, float height, const char* name){
 
-void saveBMP(const unsigned char* buf, float width, float height, const char* name){
+  const int w = width;
+  const int h = height;
+  const int row_size = 3*w;
+  const int padding = (4-(row_size)%4)%4;
 
-  FILE *f;
-  unsigned char *img = NULL;
-
-  w = width;
-  h = height;
-
-  float red[w][h];
-  float blue[w][h];
-  float green[w][h];
-
-  for (int i = 0; i < w; i++) {
-    for (int j = 0, l = h-1; j < h; j++, l--) {
-      red[i][l] = *(buf + (3*(w*j + i)));
-      green[i][l] = *(buf + (3*(w*j + i) + 1));
-      blue[i][l] = *(buf + (3*(w*j + i) + 2));
-    }
-  }
-
-  int filesize = 54 + 3*w*h;  //w is your image width, h is image height, both int
-
-  img = (unsigned char *)malloc(3*w*h);
-  memset(img,0,3*w*h);
-
-  for(int i=0; i<w; i++)
-  {
-      for(int j=0; j<h; j++)
-      {
-          int x=i; int y=(h-1)-j;
-          float r = red[i][j]*255;
-          float g = green[i][j]*255;
-          float b = blue[i][j]*255;
-          if (r > 255) r=255;
-          if (g > 255) g=255;
-          if (b > 255) b=255;
-          img[(x+y*w)*3+2] = (unsigned char)(r);
-          img[(x+y*w)*3+1] = (unsigned char)(g);
-          img[(x+y*w)*3+0] = (unsigned char)(b);
-      }
-  }
+  int filesize = 54 + (row_size + padding)*h;
 
   unsigned char bmpfileheader[14] = {'B','M', 0,0,0,0, 0,0, 0,0, 54,0,0,0};
   unsigned char bmpinfoheader[40] = {40,0,0,0, 0,0,0,0, 0,0,0,0, 1,0, 24,0};
@@ -66,16 +32,27 @@ void saveBMP(const unsigned char* buf, float width, float height, const char* na
   bmpinfoheader[10] = (unsigned char)(       h>>16);
   bmpinfoheader[11] = (unsigned char)(       h>>24);
 
-  f = fopen(name,"wb");
+  FILE *f = fopen(name,"wb");
+  if(!f)
+    return;
   fwrite(bmpfileheader,1,14,f);
   fwrite(bmpinfoheader,1,40,f);
-  for(int i=0; i<h; i++)
+  // BMP rows are stored bottom-up, as BGR.
+  unsigned char *row = (unsigned char *)malloc(row_size);
+  for(int j=h-1; j>=0; j--)
   {
-      fwrite(img+(w*(h-i-1)*3),3,w,f);
-      fwrite(bmppad,1,(4-(w*3)%4)%4,f);
+      const unsigned char *src = buf + row_size*j;
+      for(int i=0; i<w; i++)
+      {
+          row[3*i+0] = src[3*i+2];
+          row[3*i+1] = src[3*i+1];
+          row[3*i+2] = src[3*i+0];
+      }
+      fwrite(row,1,row_size,f);
+      fwrite(bmppad,1,padding,f);
   }
 
-  free(img);
+  free(row);
   fclose(f);
 
 }
@@ -0,0 +1,78 @@
+#ifndef SPAN_BLEND_INCLUDED
+#define SPAN_BLEND_INCLUDED
+
+#include "agg_pixfmt_rgb.h"
+
+// Vectorized versions of the solid-colour span blends of AGG's rgb24 pixel format.
+//
+// The kernels produce exactly the same bytes as agg::blender_rgb: lerp(p, q, a) is
+// computed as (v + (v >> 8)) >> 8 with v = p*(255-a) + q*a + 128, which equals AGG's
+// signed formula for every p, q and a, and fits in unsigned 16-bit lanes. The fastest
+// implementation the CPU supports is chosen the first time a kernel is called.
+namespace span_blend {
+
+  enum implementation { scalar = 0, sse2 = 1, avx2 = 2, neon = 3 };
+
+  // Blends len pixels at p towards rgb, given in memory order, by multiply(alpha, covers[i]).
+  void blend_solid_span(agg::int8u* p, unsigned len, const agg::int8u* rgb, agg::int8u alpha, const agg::int8u* covers);
+
+  // Blends len pixels at p towards rgb by alpha.
+  void blend_hline(agg::int8u* p, unsigned len, const agg::int8u* rgb, agg::int8u alpha);
+
+  // Sets len pixels at p to rgb.
+  void fill_hline(agg::int8u* p, unsigned len, const agg::int8u* rgb);
+
+  implementation current_implementation();
+
+  const char* implementation_name(implementation impl);
+
+  // Switches every kernel to the given implementation, for benchmarks. Returns false,
+  // changing nothing, if it is not supported by this CPU or build.
+  bool set_implementation(implementation impl);
+
+  // agg::pixfmt_rgb24 with its solid-colour horizontal blends replaced by the kernels
+  // above. renderer_base and the scanline renderers call these statically, so every
+  // anti-aliased fill, hairline and glyph drawn through it is vectorized.
+  template<class Order>
+  class pixfmt_rgb24 : public agg::pixfmt_alpha_blend_rgb<agg::blender_rgb<agg::rgba8, Order>, agg::rendering_buffer, 3>
+  {
+    typedef agg::pixfmt_alpha_blend_rgb<agg::blender_rgb<agg::rgba8, Order>, agg::rendering_buffer, 3> base_type;
+
+  public:
+    typedef agg::rgba8 color_type;
+
+    explicit pixfmt_rgb24(agg::rendering_buffer& rb) : base_type(rb) {}
+
+    void copy_hline(int x, int y, unsigned len, const color_type& c){
+      const agg::int8u rgb[3] = { pixel_component(c, 0), pixel_component(c, 1), pixel_component(c, 2) };
+      fill_hline(this->pix_ptr(x, y), len, rgb);
+    }
+
+    void blend_hline(int x, int y, unsigned len, const color_type& c, agg::int8u cover){
+      if (c.is_transparent())
+        return;
+      const agg::int8u rgb[3] = { pixel_component(c, 0), pixel_component(c, 1), pixel_component(c, 2) };
+      agg::int8u alpha = color_type::mult_cover(c.a, cover);
+      if (alpha == color_type::base_mask)
+        fill_hline(this->pix_ptr(x, y), len, rgb);
+      else
+        span_blend::blend_hline(this->pix_ptr(x, y), len, rgb, alpha);
+    }
+
+    void blend_solid_hspan(int x, int y, unsigned len, const color_type& c, const agg::int8u* covers){
+      if (c.is_transparent())
+        return;
+      const agg::int8u rgb[3] = { pixel_component(c, 0), pixel_component(c, 1), pixel_component(c, 2) };
+      blend_solid_span(this->pix_ptr(x, y), len, rgb, c.a, covers);
+    }
+
+  private:
+    // The component of c stored at the given byte of a pixel.
+    static agg::int8u pixel_component(const color_type& c, int index){
+      return index == Order::R ? c.r : index == Order::G ? c.g : c.b;
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,387 @@
+#include <atomic>
+#include <cstring>
+
+#include "include/span_blend.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define SPAN_BLEND_X86 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+// AVX2 kernels are compiled for AVX2 regardless of the build's target, and only called
+// when the CPU supports it.
+#define SPAN_BLEND_AVX2 1
+#include <immintrin.h>
+#define SPAN_BLEND_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#define SPAN_BLEND_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace span_blend {
+
+  typedef agg::int8u int8u;
+
+  namespace {
+
+    // Scalar kernels, the same arithmetic as agg::blender_rgb.
+
+    inline int8u lerp(int8u p, int8u q, int8u a){
+      return agg::rgba8::lerp(p, q, a);
+    }
+
+    void blend_solid_span_scalar(int8u* p, unsigned len, const int8u* rgb, int8u alpha, const int8u* covers){
+      for (unsigned i = 0; i < len; i++, p += 3) {
+        int8u a = agg::rgba8::mult_cover(alpha, covers[i]);
+        p[0] = lerp(p[0], rgb[0], a);
+        p[1] = lerp(p[1], rgb[1], a);
+        p[2] = lerp(p[2], rgb[2], a);
+      }
+    }
+
+    void blend_hline_scalar(int8u* p, unsigned len, const int8u* rgb, int8u alpha){
+      for (unsigned i = 0; i < len; i++, p += 3) {
+        p[0] = lerp(p[0], rgb[0], alpha);
+        p[1] = lerp(p[1], rgb[1], alpha);
+        p[2] = lerp(p[2], rgb[2], alpha);
+      }
+    }
+
+    void fill_hline_scalar(int8u* p, unsigned len, const int8u* rgb){
+      for (unsigned i = 0; i < len; i++, p += 3) {
+        p[0] = rgb[0];
+        p[1] = rgb[1];
+        p[2] = rgb[2];
+      }
+    }
+
+#if SPAN_BLEND_X86
+
+    // 48 bytes holding 16 pixels of rgb.
+    void fill_pattern(int8u* pattern, const int8u* rgb){
+      for (int i = 0; i < 48; i++) {
+        pattern[i] = rgb[i % 3];
+      }
+    }
+
+    // (v + (v >> 8)) >> 8 on 16-bit lanes holding v = p*(255-a) + q*a + 128.
+    inline __m128i sse2_round(__m128i v){
+      return _mm_srli_epi16(_mm_add_epi16(v, _mm_srli_epi16(v, 8)), 8);
+    }
+
+    // Blends 8 bytes, widened to 16-bit lanes, by the alphas in a.
+    inline __m128i sse2_lerp(__m128i p, __m128i q, __m128i a){
+      const __m128i mask = _mm_set1_epi16(255);
+      const __m128i half = _mm_set1_epi16(128);
+      __m128i v = _mm_add_epi16(_mm_mullo_epi16(p, _mm_sub_epi16(mask, a)), _mm_mullo_epi16(q, a));
+      return sse2_round(_mm_add_epi16(v, half));
+    }
+
+    void blend_solid_span_sse2(int8u* p, unsigned len, const int8u* rgb, int8u alpha, const int8u* covers){
+      if (len < 16)
+        return blend_solid_span_scalar(p, len, rgb, alpha, covers);
+      int8u pattern[48];
+      fill_pattern(pattern, rgb);
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i half = _mm_set1_epi16(128);
+      const __m128i alpha16 = _mm_set1_epi16(alpha);
+      // SSE2 cannot shuffle bytes, so the alphas of each channel are spread out in memory.
+      alignas(16) agg::int16u pixel_alpha[16];
+      alignas(16) agg::int16u channel_alpha[48];
+      for (; len >= 16; len -= 16, p += 48, covers += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i*)covers);
+        __m128i lo = sse2_round(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(c, zero), alpha16), half));
+        __m128i hi = sse2_round(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(c, zero), alpha16), half));
+        _mm_store_si128((__m128i*)pixel_alpha, lo);
+        _mm_store_si128((__m128i*)(pixel_alpha + 8), hi);
+        for (int i = 0; i < 16; i++) {
+          channel_alpha[3*i] = channel_alpha[3*i+1] = channel_alpha[3*i+2] = pixel_alpha[i];
+        }
+        for (int k = 0; k < 3; k++) {
+          __m128i d = _mm_loadu_si128((const __m128i*)(p + 16*k));
+          __m128i q = _mm_loadu_si128((const __m128i*)(pattern + 16*k));
+          __m128i a_lo = _mm_load_si128((const __m128i*)(channel_alpha + 16*k));
+          __m128i a_hi = _mm_load_si128((const __m128i*)(channel_alpha + 16*k + 8));
+          __m128i r_lo = sse2_lerp(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(q, zero), a_lo);
+          __m128i r_hi = sse2_lerp(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(q, zero), a_hi);
+          _mm_storeu_si128((__m128i*)(p + 16*k), _mm_packus_epi16(r_lo, r_hi));
+        }
+      }
+      blend_solid_span_scalar(p, len, rgb, alpha, covers);
+    }
+
+    void blend_hline_sse2(int8u* p, unsigned len, const int8u* rgb, int8u alpha){
+      if (len < 16)
+        return blend_hline_scalar(p, len, rgb, alpha);
+      int8u pattern[48];
+      fill_pattern(pattern, rgb);
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i inverse = _mm_set1_epi16(255 - alpha);
+      // q*a + 128 is the same for every pixel, for each of the three phases of the pattern.
+      __m128i qa_lo[3], qa_hi[3];
+      for (int k = 0; k < 3; k++) {
+        __m128i q = _mm_loadu_si128((const __m128i*)(pattern + 16*k));
+        qa_lo[k] = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(q, zero), _mm_set1_epi16(alpha)), _mm_set1_epi16(128));
+        qa_hi[k] = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(q, zero), _mm_set1_epi16(alpha)), _mm_set1_epi16(128));
+      }
+      for (; len >= 16; len -= 16, p += 48) {
+        for (int k = 0; k < 3; k++) {
+          __m128i d = _mm_loadu_si128((const __m128i*)(p + 16*k));
+          __m128i r_lo = sse2_round(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inverse), qa_lo[k]));
+          __m128i r_hi = sse2_round(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inverse), qa_hi[k]));
+          _mm_storeu_si128((__m128i*)(p + 16*k), _mm_packus_epi16(r_lo, r_hi));
+        }
+      }
+      blend_hline_scalar(p, len, rgb, alpha);
+    }
+
+    void fill_hline_sse2(int8u* p, unsigned len, const int8u* rgb){
+      if (len < 16)
+        return fill_hline_scalar(p, len, rgb);
+      int8u pattern[48];
+      fill_pattern(pattern, rgb);
+      const __m128i q0 = _mm_loadu_si128((const __m128i*)pattern);
+      const __m128i q1 = _mm_loadu_si128((const __m128i*)(pattern + 16));
+      const __m128i q2 = _mm_loadu_si128((const __m128i*)(pattern + 32));
+      for (; len >= 16; len -= 16, p += 48) {
+        _mm_storeu_si128((__m128i*)p, q0);
+        _mm_storeu_si128((__m128i*)(p + 16), q1);
+        _mm_storeu_si128((__m128i*)(p + 32), q2);
+      }
+      fill_hline_scalar(p, len, rgb);
+    }
+
+#endif
+
+#if SPAN_BLEND_AVX2
+
+    SPAN_BLEND_TARGET_AVX2
+    inline __m256i avx2_round(__m256i v){
+      return _mm256_srli_epi16(_mm256_add_epi16(v, _mm256_srli_epi16(v, 8)), 8);
+    }
+
+    // Blends 16 bytes by the alphas of their pixels, in 16-bit lanes.
+    SPAN_BLEND_TARGET_AVX2
+    inline __m128i avx2_lerp(__m128i p, __m128i q, __m128i a){
+      const __m256i mask = _mm256_set1_epi16(255);
+      const __m256i half = _mm256_set1_epi16(128);
+      __m256i a16 = _mm256_cvtepu8_epi16(a);
+      __m256i v = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_cvtepu8_epi16(p), _mm256_sub_epi16(mask, a16)),
+                                   _mm256_mullo_epi16(_mm256_cvtepu8_epi16(q), a16));
+      __m256i r = avx2_round(_mm256_add_epi16(v, half));
+      return _mm_packus_epi16(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+    }
+
+    SPAN_BLEND_TARGET_AVX2
+    void blend_solid_span_avx2(int8u* p, unsigned len, const int8u* rgb, int8u alpha, const int8u* covers){
+      if (len < 16)
+        return blend_solid_span_scalar(p, len, rgb, alpha, covers);
+      int8u pattern[48];
+      fill_pattern(pattern, rgb);
+      const __m128i q0 = _mm_loadu_si128((const __m128i*)pattern);
+      const __m128i q1 = _mm_loadu_si128((const __m128i*)(pattern + 16));
+      const __m128i q2 = _mm_loadu_si128((const __m128i*)(pattern + 32));
+      // Spread the alphas of 16 pixels over their 48 bytes.
+      const __m128i spread0 = _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5);
+      const __m128i spread1 = _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10);
+      const __m128i spread2 = _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15);
+      const __m256i alpha16 = _mm256_set1_epi16(alpha);
+      const __m256i half = _mm256_set1_epi16(128);
+      for (; len >= 16; len -= 16, p += 48, covers += 16) {
+        __m256i c = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)covers));
+        __m256i a16 = avx2_round(_mm256_add_epi16(_mm256_mullo_epi16(c, alpha16), half));
+        __m128i a = _mm_packus_epi16(_mm256_castsi256_si128(a16), _mm256_extracti128_si256(a16, 1));
+        __m128i d0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i d1 = _mm_loadu_si128((const __m128i*)(p + 16));
+        __m128i d2 = _mm_loadu_si128((const __m128i*)(p + 32));
+        _mm_storeu_si128((__m128i*)p, avx2_lerp(d0, q0, _mm_shuffle_epi8(a, spread0)));
+        _mm_storeu_si128((__m128i*)(p + 16), avx2_lerp(d1, q1, _mm_shuffle_epi8(a, spread1)));
+        _mm_storeu_si128((__m128i*)(p + 32), avx2_lerp(d2, q2, _mm_shuffle_epi8(a, spread2)));
+      }
+      // Avoid the penalty for mixing AVX and legacy SSE code in the tail.
+      _mm256_zeroupper();
+      blend_solid_span_scalar(p, len, rgb, alpha, covers);
+    }
+
+    SPAN_BLEND_TARGET_AVX2
+    void blend_hline_avx2(int8u* p, unsigned len, const int8u* rgb, int8u alpha){
+      if (len < 32)
+        return blend_hline_sse2(p, len, rgb, alpha);
+      int8u pattern[96];
+      fill_pattern(pattern, rgb);
+      fill_pattern(pattern + 48, rgb);
+      const __m256i zero = _mm256_setzero_si256();
+      const __m256i inverse = _mm256_set1_epi16(255 - alpha);
+      // 32 bytes hold a whole number of pixels every 3 vectors, so there are three phases.
+      __m256i qa_lo[3], qa_hi[3];
+      for (int k = 0; k < 3; k++) {
+        __m256i q = _mm256_loadu_si256((const __m256i*)(pattern + 32*k));
+        qa_lo[k] = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(q, zero), _mm256_set1_epi16(alpha)), _mm256_set1_epi16(128));
+        qa_hi[k] = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(q, zero), _mm256_set1_epi16(alpha)), _mm256_set1_epi16(128));
+      }
+      for (; len >= 32; len -= 32, p += 96) {
+        for (int k = 0; k < 3; k++) {
+          __m256i d = _mm256_loadu_si256((const __m256i*)(p + 32*k));
+          __m256i r_lo = avx2_round(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), inverse), qa_lo[k]));
+          __m256i r_hi = avx2_round(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), inverse), qa_hi[k]));
+          // Unpacking and packing work within 128-bit lanes, so the bytes come back in order.
+          _mm256_storeu_si256((__m256i*)(p + 32*k), _mm256_packus_epi16(r_lo, r_hi));
+        }
+      }
+      _mm256_zeroupper();
+      blend_hline_sse2(p, len, rgb, alpha);
+    }
+
+#endif
+
+#if SPAN_BLEND_NEON
+
+    // Blends 16 bytes of one channel by the alphas in a.
+    inline uint8x16_t neon_lerp(uint8x16_t p, uint8x16_t q, uint8x16_t a){
+      const uint16x8_t half = vdupq_n_u16(128);
+      uint8x16_t inverse = vmvnq_u8(a);
+      uint16x8_t lo = vaddq_u16(vmlal_u8(vmull_u8(vget_low_u8(p), vget_low_u8(inverse)), vget_low_u8(q), vget_low_u8(a)), half);
+      uint16x8_t hi = vaddq_u16(vmlal_u8(vmull_u8(vget_high_u8(p), vget_high_u8(inverse)), vget_high_u8(q), vget_high_u8(a)), half);
+      return vcombine_u8(vshrn_n_u16(vsraq_n_u16(lo, lo, 8), 8), vshrn_n_u16(vsraq_n_u16(hi, hi, 8), 8));
+    }
+
+    void blend_solid_span_neon(int8u* p, unsigned len, const int8u* rgb, int8u alpha, const int8u* covers){
+      const uint8x16_t r = vdupq_n_u8(rgb[0]), g = vdupq_n_u8(rgb[1]), b = vdupq_n_u8(rgb[2]);
+      const uint8x8_t alpha8 = vdup_n_u8(alpha);
+      const uint16x8_t half = vdupq_n_u16(128);
+      for (; len >= 16; len -= 16, p += 48, covers += 16) {
+        uint8x16_t c = vld1q_u8(covers);
+        uint16x8_t lo = vaddq_u16(vmull_u8(vget_low_u8(c), alpha8), half);
+        uint16x8_t hi = vaddq_u16(vmull_u8(vget_high_u8(c), alpha8), half);
+        uint8x16_t a = vcombine_u8(vshrn_n_u16(vsraq_n_u16(lo, lo, 8), 8), vshrn_n_u16(vsraq_n_u16(hi, hi, 8), 8));
+        uint8x16x3_t d = vld3q_u8(p);
+        d.val[0] = neon_lerp(d.val[0], r, a);
+        d.val[1] = neon_lerp(d.val[1], g, a);
+        d.val[2] = neon_lerp(d.val[2], b, a);
+        vst3q_u8(p, d);
+      }
+      blend_solid_span_scalar(p, len, rgb, alpha, covers);
+    }
+
+    void blend_hline_neon(int8u* p, unsigned len, const int8u* rgb, int8u alpha){
+      const uint8x16_t r = vdupq_n_u8(rgb[0]), g = vdupq_n_u8(rgb[1]), b = vdupq_n_u8(rgb[2]);
+      const uint8x16_t a = vdupq_n_u8(alpha);
+      for (; len >= 16; len -= 16, p += 48) {
+        uint8x16x3_t d = vld3q_u8(p);
+        d.val[0] = neon_lerp(d.val[0], r, a);
+        d.val[1] = neon_lerp(d.val[1], g, a);
+        d.val[2] = neon_lerp(d.val[2], b, a);
+        vst3q_u8(p, d);
+      }
+      blend_hline_scalar(p, len, rgb, alpha);
+    }
+
+    void fill_hline_neon(int8u* p, unsigned len, const int8u* rgb){
+      uint8x16x3_t d;
+      d.val[0] = vdupq_n_u8(rgb[0]);
+      d.val[1] = vdupq_n_u8(rgb[1]);
+      d.val[2] = vdupq_n_u8(rgb[2]);
+      for (; len >= 16; len -= 16, p += 48) {
+        vst3q_u8(p, d);
+      }
+      fill_hline_scalar(p, len, rgb);
+    }
+
+#endif
+
+    struct kernels {
+      implementation impl;
+      void (*blend_solid_span)(int8u*, unsigned, const int8u*, int8u, const int8u*);
+      void (*blend_hline)(int8u*, unsigned, const int8u*, int8u);
+      void (*fill_hline)(int8u*, unsigned, const int8u*);
+    };
+
+    const kernels scalar_kernels = { scalar, blend_solid_span_scalar, blend_hline_scalar, fill_hline_scalar };
+#if SPAN_BLEND_X86
+    const kernels sse2_kernels = { sse2, blend_solid_span_sse2, blend_hline_sse2, fill_hline_sse2 };
+#endif
+#if SPAN_BLEND_AVX2
+    const kernels avx2_kernels = { avx2, blend_solid_span_avx2, blend_hline_avx2, fill_hline_sse2 };
+#endif
+#if SPAN_BLEND_NEON
+    const kernels neon_kernels = { neon, blend_solid_span_neon, blend_hline_neon, fill_hline_neon };
+#endif
+
+    const kernels* supported_kernels(implementation impl){
+      switch (impl) {
+        case scalar:
+          return &scalar_kernels;
+#if SPAN_BLEND_X86
+        case sse2:
+          return &sse2_kernels;
+#endif
+#if SPAN_BLEND_AVX2
+        case avx2:
+          __builtin_cpu_init();
+          return __builtin_cpu_supports("avx2") ? &avx2_kernels : 0;
+#endif
+#if SPAN_BLEND_NEON
+        case neon:
+          return &neon_kernels;
+#endif
+        default:
+          return 0;
+      }
+    }
+
+    const kernels* best_kernels(){
+      const implementation preferred[] = { avx2, neon, sse2 };
+      for (int i = 0; i < 3; i++) {
+        if (const kernels* k = supported_kernels(preferred[i]))
+          return k;
+      }
+      return &scalar_kernels;
+    }
+
+    std::atomic<const kernels*> selected_kernels(0);
+
+    const kernels& active(){
+      const kernels* k = selected_kernels.load(std::memory_order_acquire);
+      if (!k) {
+        k = best_kernels();
+        selected_kernels.store(k, std::memory_order_release);
+      }
+      return *k;
+    }
+
+  }
+
+  void blend_solid_span(int8u* p, unsigned len, const int8u* rgb, int8u alpha, const int8u* covers){
+    active().blend_solid_span(p, len, rgb, alpha, covers);
+  }
+
+  void blend_hline(int8u* p, unsigned len, const int8u* rgb, int8u alpha){
+    active().blend_hline(p, len, rgb, alpha);
+  }
+
+  void fill_hline(int8u* p, unsigned len, const int8u* rgb){
+    active().fill_hline(p, len, rgb);
+  }
+
+  implementation current_implementation(){
+    return active().impl;
+  }
+
+  const char* implementation_name(implementation impl){
+    switch (impl) {
+      case sse2: return "sse2";
+      case avx2: return "avx2";
+      case neon: return "neon";
+      default: return "scalar";
+    }
+  }
+
+  bool set_implementation(implementation impl){
+    const kernels* k = supported_kernels(impl);
+    if (!k)
+      return false;
+    selected_kernels.store(k, std::memory_order_release);
+    return true;
+  }
+
+}
@@ -0,0 +1,64 @@
+import Foundation
+
+/// A destination for the UTF-8 encoded document produced by an `SVGRenderer`.
+///
+/// The renderer collects output in a small fixed-size buffer and hands it to the sink
+/// whenever the buffer fills up, so a sink never sees more than one buffer's worth of
+/// bytes at a time and the renderer never holds the whole document in memory.
+public protocol SVGOutputSink: AnyObject {
+    /// Consumes the given bytes. The buffer is only valid for the duration of the call.
+    func write(_ bytes: UnsafeRawBufferPointer)
+}
+
+/// A growable, in-memory byte buffer which can be used as an `SVGOutputSink`.
+public final class SVGByteBuffer: SVGOutputSink {
+
+    /// The bytes written to the buffer so far.
+    public private(set) var bytes: [UInt8] = []
+
+    public init(minimumCapacity: Int = 0) {
+        bytes.reserveCapacity(minimumCapacity)
+    }
+
+    public var count: Int {
+        return bytes.count
+    }
+
+    /// The contents of the buffer, decoded as UTF-8.
+    public var string: String {
+        return String(decoding: bytes, as: UTF8.self)
+    }
+
+    public func write(_ bytes: UnsafeRawBufferPointer) {
+        self.bytes.append(contentsOf: bytes)
+    }
+
+    public func removeAll(keepingCapacity: Bool = true) {
+        bytes.removeAll(keepingCapacity: keepingCapacity)
+    }
+}
+
+extension FileHandle: SVGOutputSink {
+    public func write(_ bytes: UnsafeRawBufferPointer) {
+        guard let base = bytes.baseAddress, bytes.count > 0 else { return }
+        // The data only lives for the duration of the call, so it is safe to borrow
+        // the renderer's buffer rather than copying it.
+        let data = Data(bytesNoCopy: UnsafeMutableRawPointer(mutating: base),
+                        count: bytes.count,
+                        deallocator: .none)
+        write(data)
+    }
+}
+
+extension OutputStream: SVGOutputSink {
+    public func write(_ bytes: UnsafeRawBufferPointer) {
+        guard let base = bytes.baseAddress?.assumingMemoryBound(to: UInt8.self) else { return }
+        var written = 0
+        while written < bytes.count {
+            let result = write(base + written, maxLength: bytes.count - written)
+            // A failed or closed stream reports its error through `streamError`.
+            guard result > 0 else { return }
+            written += result
+        }
+    }
+}
@@ -0,0 +1,212 @@
+import Foundation
+
+/// A minimal PNG encoder for embedding raster images in SVG documents.
+///
+/// The image data is compressed as a single fixed-Huffman deflate block which only looks
+/// for repeats of the previous pixel and of the pixel above. That captures most of the
+/// redundancy in rasterized plot data (such as heatmap cells) while keeping the encoder
+/// small and linear-time.
+enum SVGPNGEncoder {
+
+    /// Encodes non-premultiplied, 8-bit RGBA pixels, in rows from the top, as a PNG file.
+    static func encode(rgba pixels: [UInt8], width: Int, height: Int) -> [UInt8] {
+        precondition(width > 0 && height > 0 && pixels.count == width * height * 4,
+                     "SVGPNGEncoder: expected \(width * height * 4) bytes of RGBA data, got \(pixels.count).")
+        // Each row is prefixed with its filter type (0: none).
+        let rowStride = width * 4 + 1
+        var scanlines = [UInt8](repeating: 0, count: rowStride * height)
+        for row in 0..<height {
+            let source = row * width * 4
+            scanlines.replaceSubrange((row * rowStride + 1)..<((row + 1) * rowStride),
+                                      with: pixels[source..<(source + width * 4)])
+        }
+
+        var png: [UInt8] = [137, 80, 78, 71, 13, 10, 26, 10]
+        var header: [UInt8] = []
+        appendBigEndian(UInt32(width), to: &header)
+        appendBigEndian(UInt32(height), to: &header)
+        // Bit depth 8, colour type 6 (RGBA), default compression, filtering and interlacing.
+        header += [8, 6, 0, 0, 0]
+        appendChunk("IHDR", header, to: &png)
+        appendChunk("IDAT", zlibCompress(scanlines, rowStride: rowStride), to: &png)
+        appendChunk("IEND", [], to: &png)
+        return png
+    }
+
+    // MARK: Chunks.
+
+    private static func appendChunk(_ type: String, _ data: [UInt8], to png: inout [UInt8]) {
+        appendBigEndian(UInt32(data.count), to: &png)
+        let typeAndData = Array(type.utf8) + data
+        png += typeAndData
+        appendBigEndian(crc32(typeAndData), to: &png)
+    }
+
+    private static func appendBigEndian(_ value: UInt32, to bytes: inout [UInt8]) {
+        bytes += [UInt8(truncatingIfNeeded: value >> 24), UInt8(truncatingIfNeeded: value >> 16),
+                  UInt8(truncatingIfNeeded: value >> 8), UInt8(truncatingIfNeeded: value)]
+    }
+
+    private static let crcTable: [UInt32] = (0..<256).map { n -> UInt32 in
+        var c = UInt32(n)
+        for _ in 0..<8 {
+            c = (c & 1) != 0 ? 0xEDB88320 ^ (c >> 1) : c >> 1
+        }
+        return c
+    }
+
+    private static func crc32(_ bytes: [UInt8]) -> UInt32 {
+        var crc: UInt32 = 0xFFFFFFFF
+        for byte in bytes {
+            crc = crcTable[Int((crc ^ UInt32(byte)) & 0xFF)] ^ (crc >> 8)
+        }
+        return crc ^ 0xFFFFFFFF
+    }
+
+    private static func adler32(_ bytes: [UInt8]) -> UInt32 {
+        var a: UInt32 = 1
+        var b: UInt32 = 0
+        var index = 0
+        while index < bytes.count {
+            // 5552 is the largest block for which `b` cannot overflow before the modulo.
+            let end = min(index + 5552, bytes.count)
+            while index < end {
+                a &+= UInt32(bytes[index])
+                b &+= a
+                index += 1
+            }
+            a %= 65521
+            b %= 65521
+        }
+        return (b << 16) | a
+    }
+
+    // MARK: Deflate.
+
+    private struct BitWriter {
+        var bytes: [UInt8] = []
+        private var accumulator: UInt64 = 0
+        private var bitCount: UInt64 = 0
+
+        /// Writes the low `count` bits of `value`, least-significant bit first.
+        mutating func write(_ value: UInt32, bitCount count: Int) {
+            accumulator |= UInt64(value) << bitCount
+            bitCount += UInt64(count)
+            while bitCount >= 8 {
+                bytes.append(UInt8(truncatingIfNeeded: accumulator))
+                accumulator >>= 8
+                bitCount -= 8
+            }
+        }
+
+        mutating func finish() {
+            if bitCount > 0 {
+                bytes.append(UInt8(truncatingIfNeeded: accumulator))
+            }
+            accumulator = 0
+            bitCount = 0
+        }
+    }
+
+    /// Huffman codes are packed most-significant bit first.
+    private static func reversed(_ code: UInt32, bitCount: Int) -> UInt32 {
+        var result: UInt32 = 0
+        for bit in 0..<bitCount {
+            result = (result << 1) | ((code >> UInt32(bit)) & 1)
+        }
+        return result
+    }
+
+    /// The fixed literal/length code of each symbol, already bit-reversed.
+    private static let literalCodes: [(code: UInt32, bitCount: Int)] = (0..<288).map { symbol -> (code: UInt32, bitCount: Int) in
+        switch symbol {
+        case 0..<144:   return (SVGPNGEncoder.reversed(0x30 + UInt32(symbol), bitCount: 8), 8)
+        case 144..<256: return (SVGPNGEncoder.reversed(0x190 + UInt32(symbol - 144), bitCount: 9), 9)
+        case 256..<280: return (SVGPNGEncoder.reversed(UInt32(symbol - 256), bitCount: 7), 7)
+        default:        return (SVGPNGEncoder.reversed(0xC0 + UInt32(symbol - 280), bitCount: 8), 8)
+        }
+    }
+
+    private static let lengthBases: [Int] = [3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                             35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258]
+    private static let lengthExtraBits: [Int] = [0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                                 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0]
+    private static let distanceBases: [Int] = [1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                               257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                               8193, 12289, 16385, 24577]
+    private static let maxMatchLength = 258
+    private static let maxDistance = 32768
+
+    /// The index into `lengthBases` for each match length from 0 to 258.
+    private static let lengthCodeIndices: [Int] = (0...SVGPNGEncoder.maxMatchLength).map { length -> Int in
+        var index = 0
+        while index + 1 < SVGPNGEncoder.lengthBases.count && SVGPNGEncoder.lengthBases[index + 1] <= length {
+            index += 1
+        }
+        return index
+    }
+
+    private static func zlibCompress(_ data: [UInt8], rowStride: Int) -> [UInt8] {
+        var writer = BitWriter()
+        // zlib header: deflate with a 32K window, no dictionary, fastest level.
+        writer.bytes = [0x78, 0x01]
+        // A single, final block using the fixed Huffman codes.
+        writer.write(1, bitCount: 1)
+        writer.write(1, bitCount: 2)
+
+        // Candidate match distances: the previous pixel and the pixel above.
+        let distances = [4, rowStride].filter { $0 <= maxDistance }
+        let distanceCodes = distances.map { distance -> (code: UInt32, extra: UInt32, extraBits: Int) in
+            var index = 0
+            while index + 1 < distanceBases.count && distanceBases[index + 1] <= distance {
+                index += 1
+            }
+            let extraBits = max(0, index / 2 - 1)
+            return (reversed(UInt32(index), bitCount: 5),
+                    UInt32(distance - distanceBases[index]), extraBits)
+        }
+
+        data.withUnsafeBufferPointer { data in
+            var position = 0
+            while position < data.count {
+                var bestLength = 0
+                var bestCandidate = 0
+                let limit = min(maxMatchLength, data.count - position)
+                for (candidate, distance) in distances.enumerated() where distance <= position {
+                    var length = 0
+                    while length < limit && data[position + length] == data[position + length - distance] {
+                        length += 1
+                    }
+                    if length > bestLength {
+                        bestLength = length
+                        bestCandidate = candidate
+                    }
+                }
+                if bestLength >= 3 {
+                    let lengthIndex = lengthCodeIndices[bestLength]
+                    let lengthCode = literalCodes[257 + lengthIndex]
+                    writer.write(lengthCode.code, bitCount: lengthCode.bitCount)
+                    writer.write(UInt32(bestLength - lengthBases[lengthIndex]),
+                                 bitCount: lengthExtraBits[lengthIndex])
+                    let distanceCode = distanceCodes[bestCandidate]
+                    writer.write(distanceCode.code, bitCount: 5)
+                    writer.write(distanceCode.extra, bitCount: distanceCode.extraBits)
+                    position += bestLength
+                } else {
+                    let literal = literalCodes[Int(data[position])]
+                    writer.write(literal.code, bitCount: literal.bitCount)
+                    position += 1
+                }
+            }
+        }
+        let endOfBlock = literalCodes[256]
+        writer.write(endOfBlock.code, bitCount: endOfBlock.bitCount)
+        writer.finish()
+
+        var output = writer.bytes
+        let checksum = adler32(data)
+        output += [UInt8(truncatingIfNeeded: checksum >> 24), UInt8(truncatingIfNeeded: checksum >> 16),
+                   UInt8(truncatingIfNeeded: checksum >> 8), UInt8(truncatingIfNeeded: checksum)]
+        return output
+    }
+}
@@ -0,0 +1,307 @@
+import Foundation
+import SwiftPlot
+
+/// A hashable copy of a `Color`.
+struct SVGColorKey: Hashable {
+    var r, g, b, a: Float
+
+    init(_ color: Color) {
+        (r, g, b, a) = (color.r, color.g, color.b, color.a)
+    }
+
+    var color: Color {
+        return Color(r, g, b, a)
+    }
+}
+
+/// The presentation attributes shared by a group of compact-encoded elements.
+struct SVGCompactStyle: Hashable {
+    var fill: SVGColorKey?
+    var stroke: SVGColorKey?
+    var strokeWidth: Float = 0
+    var isDashed = false
+
+    static func fill(_ color: Color) -> SVGCompactStyle {
+        return SVGCompactStyle(fill: SVGColorKey(color), stroke: nil)
+    }
+
+    static func stroke(_ color: Color, width: Float, isDashed: Bool) -> SVGCompactStyle {
+        return SVGCompactStyle(fill: nil, stroke: SVGColorKey(color),
+                               strokeWidth: width, isDashed: isDashed)
+    }
+
+    static func fillAndStroke(_ fill: Color, _ stroke: Color, width: Float) -> SVGCompactStyle {
+        return SVGCompactStyle(fill: SVGColorKey(fill), stroke: SVGColorKey(stroke),
+                               strokeWidth: width)
+    }
+}
+
+/// A shape which is defined once and then referenced by `<use>` elements.
+/// Dimensions are quantized to the coordinate precision.
+enum SVGCompactMarker: Hashable {
+    case circle(radius: Int64)
+    /// The offsets of each vertex from the previous one, starting from the first vertex.
+    case polygon(deltas: [Int64])
+}
+
+final class SVGCompactEncodingState {
+    /// Once this many classes have been defined, further styles are written inline.
+    /// This keeps charts where every element has a different colour from bloating the
+    /// stylesheet.
+    static let maxStyleClasses = 256
+
+    var styleClasses: [SVGCompactStyle: Int] = [:]
+    var markers: [SVGCompactMarker: Int] = [:]
+    /// The class of the currently open `<g>`, if any.
+    var openGroup: Int?
+}
+
+extension SVGRenderer {
+
+    var compactFractionDigits: Int {
+        return coordinatePrecision ?? 2
+    }
+
+    // MARK: Elements.
+
+    func drawCompactRect(_ rect: Rect, style: SVGCompactStyle) {
+        let inGroup = beginCompactElement(style: style)
+        writer.write(#"<rect x=""#)
+        writeCompactNumber(rect.origin.x)
+        writer.write(#"" y=""#)
+        writeCompactNumber(rect.origin.y)
+        writer.write(#"" width=""#)
+        writeCompactNumber(rect.size.width)
+        writer.write(#"" height=""#)
+        writeCompactNumber(rect.size.height)
+        writer.write(byte: UInt8(ascii: "\""))
+        endCompactElement(style: style, inGroup: inGroup)
+    }
+
+    func drawCompactCircle(center c: Point, radius r: Float, fillColor: Color) {
+        let marker = SVGCompactMarker.circle(
+            radius: SVGWriter.quantize(r, fractionDigits: compactFractionDigits))
+        let id = compactMarkerID(marker)
+        drawCompactUse(markerID: id, x: c.x, y: c.y, style: .fill(fillColor))
+    }
+
+    func drawCompactEllipse(center c: Point, radiusX rx: Float, radiusY ry: Float, fillColor: Color) {
+        let style = SVGCompactStyle.fill(fillColor)
+        let inGroup = beginCompactElement(style: style)
+        writer.write(#"<ellipse cx=""#)
+        writeCompactNumber(c.x)
+        writer.write(#"" cy=""#)
+        writeCompactNumber(c.y)
+        writer.write(#"" rx=""#)
+        writeCompactNumber(rx)
+        writer.write(#"" ry=""#)
+        writeCompactNumber(ry)
+        writer.write(byte: UInt8(ascii: "\""))
+        endCompactElement(style: style, inGroup: inGroup)
+    }
+
+    /// Draws a filled polygon, given in SVG coordinates, as a reference to a marker with
+    /// the same shape.
+    ///
+    /// Vertices are quantized relative to the first vertex rather than absolutely, so that
+    /// the same shape at different positions maps to the same marker.
+    func drawCompactPolygon(_ points: [Point], fillColor: Color) {
+        guard let first = points.first else { return }
+        let digits = compactFractionDigits
+        var deltas: [Int64] = []
+        deltas.reserveCapacity(points.count * 2 - 2)
+        var previousX: Int64 = 0
+        var previousY: Int64 = 0
+        for point in points.dropFirst() {
+            let x = SVGWriter.quantize(point.x - first.x, fractionDigits: digits)
+            let y = SVGWriter.quantize(point.y - first.y, fractionDigits: digits)
+            deltas.append(x - previousX)
+            deltas.append(y - previousY)
+            (previousX, previousY) = (x, y)
+        }
+        let id = compactMarkerID(.polygon(deltas: deltas))
+        drawCompactUse(markerID: id, x: first.x, y: first.y, style: .fill(fillColor))
+    }
+
+    func drawCompactLine(from p1: Point, to p2: Point, style: SVGCompactStyle) {
+        let digits = compactFractionDigits
+        let inGroup = beginCompactElement(style: style)
+        writer.write(#"<path d="M"#)
+        writePathNumber(SVGWriter.quantize(p1.x, fractionDigits: digits), separated: false)
+        writePathNumber(SVGWriter.quantize(p1.y, fractionDigits: digits), separated: true)
+        writer.write(byte: UInt8(ascii: "L"))
+        writePathNumber(SVGWriter.quantize(p2.x, fractionDigits: digits), separated: false)
+        writePathNumber(SVGWriter.quantize(p2.y, fractionDigits: digits), separated: true)
+        writer.write(byte: UInt8(ascii: "\""))
+        endCompactElement(style: style, inGroup: inGroup)
+    }
+
+    func drawCompactPolyline(_ polyline: Polyline, style: SVGCompactStyle) {
+        let digits = compactFractionDigits
+        let inGroup = beginCompactElement(style: style)
+        writer.write(#"<path d="M"#)
+        var previousX: Int64 = 0
+        var previousY: Int64 = 0
+        var isFirstPoint = true
+        var hasSegments = false
+        for point in polyline.points {
+            let converted = convertToSVGCoordinates(point)
+            let x = SVGWriter.quantize(converted.x, fractionDigits: digits)
+            let y = SVGWriter.quantize(converted.y, fractionDigits: digits)
+            if isFirstPoint {
+                writePathNumber(x, separated: false)
+                writePathNumber(y, separated: true)
+                isFirstPoint = false
+            } else if x != previousX || y != previousY {
+                // Zero-length segments are skipped; they do not change the stroke.
+                if !hasSegments {
+                    writer.write(byte: UInt8(ascii: "l"))
+                }
+                writePathNumber(x - previousX, separated: hasSegments)
+                writePathNumber(y - previousY, separated: true)
+                hasSegments = true
+            }
+            (previousX, previousY) = (x, y)
+        }
+        writer.write(byte: UInt8(ascii: "\""))
+        endCompactElement(style: style, inGroup: inGroup)
+    }
+
+    // MARK: Groups and styles.
+
+    /// Closes the currently open style group, if any.
+    func endCompactGroup() {
+        guard compactState.openGroup != nil else { return }
+        compactState.openGroup = nil
+        writer.write("\n</g>")
+    }
+
+    /// Starts an element with the given style, opening a group for it if it is not
+    /// already open. Returns `false` if the element must carry its style inline instead.
+    private func beginCompactElement(style: SVGCompactStyle) -> Bool {
+        // Pending rects may open groups of their own, so must be written first.
+        flushPendingRects()
+        var styleClass = compactState.styleClasses[style]
+        if styleClass == nil,
+           compactState.styleClasses.count < SVGCompactEncodingState.maxStyleClasses {
+            let newClass = compactState.styleClasses.count
+            compactState.styleClasses[style] = newClass
+            beginElement()
+            writer.write("<style>.s")
+            writer.write(quantized: Int64(newClass), fractionDigits: 0)
+            writer.write(byte: UInt8(ascii: "{"))
+            writeCompactDeclarations(style)
+            writer.write("}</style>")
+            styleClass = newClass
+        }
+        guard let groupClass = styleClass else {
+            beginElement()
+            return false
+        }
+        if compactState.openGroup != groupClass {
+            beginElement()
+            writer.write(#"<g class="s"#)
+            writer.write(quantized: Int64(groupClass), fractionDigits: 0)
+            writer.write(#"">"#)
+            compactState.openGroup = groupClass
+        }
+        beginElement(inGroup: true)
+        return true
+    }
+
+    /// Finishes an element started with `beginCompactElement`.
+    private func endCompactElement(style: SVGCompactStyle, inGroup: Bool) {
+        if !inGroup {
+            writer.write(#" style=""#)
+            writeCompactDeclarations(style)
+            writer.write(byte: UInt8(ascii: "\""))
+        }
+        writer.write("/>")
+    }
+
+    private func writeCompactDeclarations(_ style: SVGCompactStyle) {
+        if let fill = style.fill {
+            writer.write("fill:")
+            writeColor(fill.color)
+            if fill.a != 1 {
+                writer.write(";fill-opacity:")
+                writer.write(scalar: fill.a)
+            }
+        } else {
+            writer.write("fill:none")
+        }
+        if let stroke = style.stroke {
+            writer.write(";stroke:")
+            writeColor(stroke.color)
+            writer.write(";stroke-width:")
+            writer.write(scalar: style.strokeWidth)
+            if stroke.a != 1 {
+                writer.write(";stroke-opacity:")
+                writer.write(scalar: stroke.a)
+            }
+            if style.isDashed {
+                writer.write(";stroke-dasharray:4 1")
+            }
+        }
+    }
+
+    // MARK: Markers.
+
+    /// Returns the ID of the given marker, defining it if this is its first use.
+    private func compactMarkerID(_ marker: SVGCompactMarker) -> Int {
+        if let id = compactState.markers[marker] {
+            return id
+        }
+        let id = compactState.markers.count
+        compactState.markers[marker] = id
+        let digits = compactFractionDigits
+        // Definitions may appear inside a group, so there is no need to close it.
+        beginElement(inGroup: true)
+        switch marker {
+        case .circle(let radius):
+            writer.write(#"<defs><circle id="m"#)
+            writer.write(quantized: Int64(id), fractionDigits: 0)
+            writer.write(#"" r=""#)
+            writer.write(quantized: radius, fractionDigits: digits)
+            writer.write(#""/></defs>"#)
+        case .polygon(let deltas):
+            writer.write(#"<defs><path id="m"#)
+            writer.write(quantized: Int64(id), fractionDigits: 0)
+            writer.write(#"" d="M0 0l"#)
+            for (index, delta) in deltas.enumerated() {
+                writePathNumber(delta, separated: index != 0)
+            }
+            writer.write(#"z"/></defs>"#)
+        }
+        return id
+    }
+
+    private func drawCompactUse(markerID: Int, x: Float, y: Float, style: SVGCompactStyle) {
+        let inGroup = beginCompactElement(style: style)
+        writer.write(##"<use xlink:href="#m"##)
+        writer.write(quantized: Int64(markerID), fractionDigits: 0)
+        writer.write(#"" x=""#)
+        writeCompactNumber(x)
+        writer.write(#"" y=""#)
+        writeCompactNumber(y)
+        writer.write(byte: UInt8(ascii: "\""))
+        endCompactElement(style: style, inGroup: inGroup)
+    }
+
+    // MARK: Numbers.
+
+    private func writeCompactNumber(_ value: Float) {
+        let digits = compactFractionDigits
+        writer.write(quantized: SVGWriter.quantize(value, fractionDigits: digits),
+                     fractionDigits: digits)
+    }
+
+    /// Writes a path number, separated from the previous one by a space unless it starts
+    /// with a minus sign.
+    private func writePathNumber(_ value: Int64, separated: Bool) {
+        if separated && value >= 0 {
+            writer.write(byte: UInt8(ascii: " "))
+        }
+        writer.write(quantized: value, fractionDigits: compactFractionDigits)
+    }
+}
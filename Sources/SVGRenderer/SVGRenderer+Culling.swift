@@ -0,0 +1,85 @@
+import Foundation
+import SwiftPlot
+
+extension SVGRenderer {
+
+    /// Elements drawn while a clip rect is set are written into a group clipped to it with
+    /// a `<clipPath>`. Clipped elements are still written to the document, so elements
+    /// which lie entirely outside the clip rect are also left out, and polylines are split
+    /// into their runs of segments which may be visible.
+    public func setClipRect(_ rect: Rect?) {
+        if isClipGroupOpen {
+            beginElement()
+            writer.write("</g>")
+            isClipGroupOpen = false
+        }
+        clipRect = rect.map { convertToSVGCoordinates($0) }
+        guard let clipRect = clipRect else { return }
+        beginElement()
+        writer.write(#"<defs><clipPath id="clip"#)
+        writer.write(quantized: Int64(clipPathCount), fractionDigits: 0)
+        writer.write(#""><rect x=""#)
+        writer.write(number: clipRect.origin.x)
+        writer.write(#"" y=""#)
+        writer.write(number: clipRect.origin.y)
+        writer.write(#"" width=""#)
+        writer.write(number: clipRect.size.width)
+        writer.write(#"" height=""#)
+        writer.write(number: clipRect.size.height)
+        writer.write(#""/></clipPath></defs><g clip-path="url(#clip"#)
+        writer.write(quantized: Int64(clipPathCount), fractionDigits: 0)
+        writer.write(#")">"#)
+        clipPathCount += 1
+        isClipGroupOpen = true
+    }
+
+    /// Whether `bounds`, in SVG coordinates and widened by `margin`, lies entirely
+    /// outside the clip rect.
+    func isCulled(_ bounds: Rect, margin: Float = 0) -> Bool {
+        guard let clipRect = clipRect else { return false }
+        let bounds = bounds.normalized
+        return bounds.maxX + margin < clipRect.minX || bounds.minX - margin > clipRect.maxX
+            || bounds.maxY + margin < clipRect.minY || bounds.minY - margin > clipRect.maxY
+    }
+
+    /// Whether the bounding box of `points`, in SVG coordinates and widened by `margin`,
+    /// lies entirely outside the clip rect.
+    func isCulled(_ points: [Point], margin: Float = 0) -> Bool {
+        guard clipRect != nil, var minX = points.first?.x, var minY = points.first?.y else {
+            return false
+        }
+        var maxX = minX, maxY = minY
+        for point in points.dropFirst() {
+            minX = min(minX, point.x)
+            maxX = max(maxX, point.x)
+            minY = min(minY, point.y)
+            maxY = max(maxY, point.y)
+        }
+        return isCulled(Rect(origin: Point(minX, minY), size: Size(width: maxX - minX, height: maxY - minY)),
+                        margin: margin)
+    }
+
+    /// Returns the ranges of `points`, in SVG coordinates, covering the runs of segments
+    /// which come within `margin` of the clip rect. Every range covers at least 2 points.
+    func visibleRuns(of points: [Point], margin: Float) -> [Range<Int>] {
+        guard clipRect != nil else { return [points.indices] }
+        var runs = [Range<Int>]()
+        var runStart: Int?
+        for index in 0..<(points.count - 1) {
+            let (p1, p2) = (points[index], points[index + 1])
+            let segmentBounds = Rect(origin: p1, size: Size(width: p2.x - p1.x, height: p2.y - p1.y))
+            if isCulled(segmentBounds, margin: margin) {
+                if let start = runStart {
+                    runs.append(start..<(index + 1))
+                    runStart = nil
+                }
+            } else if runStart == nil {
+                runStart = index
+            }
+        }
+        if let start = runStart {
+            runs.append(start..<points.count)
+        }
+        return runs
+    }
+}
@@ -0,0 +1,217 @@
+import Foundation
+import SwiftPlot
+
+/// Solid rects which have been drawn but not yet written, because they might be merged
+/// with the rects drawn after them.
+final class SVGRectOptimizationState {
+    /// A horizontal run of equal-colour rects, merged into one.
+    var run: (rect: Rect, color: Color)?
+    /// Consecutive rects lying on a regular grid.
+    var grid: SVGRectGrid?
+    /// Set while pending rects are being written, so that writing them does not flush them again.
+    var isEmitting = false
+}
+
+/// Consecutive solid rects of the same size, each lying on a cell of the same regular grid.
+struct SVGRectGrid {
+    let origin: Point
+    let cellSize: Size
+    private let tolerance: Float
+
+    /// The rects exactly as drawn. Kept until the grid reaches the image threshold,
+    /// so that smaller grids can be written out unchanged.
+    private(set) var rects: [(rect: Rect, color: Color)] = []
+    /// The cells of the grid, once it has reached the image threshold.
+    private(set) var cells: [(column: Int32, row: Int32, color: Color)] = []
+    private(set) var count = 0
+
+    init(_ rect: Rect, color: Color) {
+        origin = rect.origin
+        cellSize = rect.size
+        tolerance = max(abs(rect.size.width), abs(rect.size.height)) * 1e-3
+        rects = [(rect, color)]
+        count = 1
+    }
+
+    /// Adds the rect to the grid. Returns `false` if it does not lie on a cell of the grid.
+    mutating func add(_ rect: Rect, color: Color, imageThreshold: Int) -> Bool {
+        guard abs(rect.size.width - cellSize.width) <= tolerance,
+              abs(rect.size.height - cellSize.height) <= tolerance,
+              let cell = self.cell(of: rect) else { return false }
+        count += 1
+        if cells.isEmpty && count < imageThreshold {
+            rects.append((rect, color))
+            return true
+        }
+        if cells.isEmpty {
+            // Past the threshold, the grid will be written as an image,
+            // so only the cells need to be kept.
+            cells.reserveCapacity(rects.count * 2)
+            for (pendingRect, pendingColor) in rects {
+                let pendingCell = self.cell(of: pendingRect)!
+                cells.append((pendingCell.column, pendingCell.row, pendingColor))
+            }
+            rects = []
+        }
+        cells.append((cell.column, cell.row, color))
+        return true
+    }
+
+    func cell(of rect: Rect) -> (column: Int32, row: Int32)? {
+        let column = ((rect.origin.x - origin.x) / cellSize.width).rounded()
+        let row = ((rect.origin.y - origin.y) / cellSize.height).rounded()
+        guard abs(column) < Float(Int32.max), abs(row) < Float(Int32.max),
+              abs(origin.x + column * cellSize.width - rect.origin.x) <= tolerance,
+              abs(origin.y + row * cellSize.height - rect.origin.y) <= tolerance else { return nil }
+        return (Int32(column), Int32(row))
+    }
+
+    /// The rect covering the given cell.
+    func rect(column: Int32, row: Int32) -> Rect {
+        return Rect(origin: Point(origin.x + Float(column) * cellSize.width,
+                                  origin.y + Float(row) * cellSize.height),
+                    size: cellSize)
+    }
+}
+
+extension SVGRenderer {
+
+    var optimizesRects: Bool {
+        return mergesAdjacentRects || rectGridImageThreshold != nil
+    }
+
+    /// Buffers a solid rect, in SVG coordinates, so that it can be merged with the rects
+    /// drawn after it.
+    func addOptimizedRect(_ rect: Rect, fillColor: Color) {
+        rectOptimization.isEmitting = true
+        defer { rectOptimization.isEmitting = false }
+
+        guard let threshold = rectGridImageThreshold else {
+            addToRectRun(rect, fillColor: fillColor)
+            return
+        }
+        if rectOptimization.grid?.add(rect, color: fillColor, imageThreshold: threshold) != true {
+            flushRectGrid()
+            rectOptimization.grid = SVGRectGrid(rect, color: fillColor)
+        }
+    }
+
+    /// Writes any buffered rects. This must happen before any other element is written.
+    func flushPendingRects() {
+        guard !rectOptimization.isEmitting,
+              rectOptimization.grid != nil || rectOptimization.run != nil else { return }
+        rectOptimization.isEmitting = true
+        defer { rectOptimization.isEmitting = false }
+        flushRectGrid()
+        flushRectRun()
+    }
+
+    private func addToRectRun(_ rect: Rect, fillColor: Color) {
+        guard mergesAdjacentRects else {
+            emitSolidRect(rect, fillColor: fillColor)
+            return
+        }
+        if let run = rectOptimization.run, canMerge(run, (rect, fillColor)) {
+            rectOptimization.run!.rect.size.width = rect.maxX - run.rect.minX
+            return
+        }
+        flushRectRun()
+        rectOptimization.run = (rect, fillColor)
+    }
+
+    /// Whether `next` directly continues `run` to the right, with the same colour.
+    private func canMerge(_ run: (rect: Rect, color: Color), _ next: (rect: Rect, color: Color)) -> Bool {
+        let tolerance = max(abs(run.rect.size.height), abs(next.rect.size.width)) * 1e-3
+        return run.color.r == next.color.r && run.color.g == next.color.g
+            && run.color.b == next.color.b && run.color.a == next.color.a
+            && abs(run.rect.minY - next.rect.minY) <= tolerance
+            && abs(run.rect.size.height - next.rect.size.height) <= tolerance
+            && abs(run.rect.maxX - next.rect.minX) <= tolerance
+    }
+
+    private func flushRectRun() {
+        guard let run = rectOptimization.run else { return }
+        rectOptimization.run = nil
+        emitSolidRect(run.rect, fillColor: run.color)
+    }
+
+    private func flushRectGrid() {
+        guard let grid = rectOptimization.grid else { return }
+        rectOptimization.grid = nil
+        if grid.cells.isEmpty {
+            for (rect, color) in grid.rects {
+                addToRectRun(rect, fillColor: color)
+            }
+        } else if let image = makeGridImage(grid) {
+            flushRectRun()
+            drawEmbeddedImage(image)
+        } else {
+            for cell in grid.cells {
+                addToRectRun(grid.rect(column: cell.column, row: cell.row), fillColor: cell.color)
+            }
+        }
+    }
+
+    // MARK: Grid images.
+
+    struct EmbeddedImage {
+        var frame: Rect
+        var pixelWidth: Int
+        var pixelHeight: Int
+        var rgba: [UInt8]
+    }
+
+    /// Rasterizes the grid with one pixel per cell. Returns `nil` if the grid is too sparse
+    /// for an image to be worthwhile.
+    private func makeGridImage(_ grid: SVGRectGrid) -> EmbeddedImage? {
+        var minColumn = Int32.max, maxColumn = Int32.min
+        var minRow = Int32.max, maxRow = Int32.min
+        for cell in grid.cells {
+            minColumn = min(minColumn, cell.column)
+            maxColumn = max(maxColumn, cell.column)
+            minRow = min(minRow, cell.row)
+            maxRow = max(maxRow, cell.row)
+        }
+        let width = Int(maxColumn) - Int(minColumn) + 1
+        let height = Int(maxRow) - Int(minRow) + 1
+        guard Double(width) * Double(height) <= Double(grid.cells.count * 2) else { return nil }
+
+        // Cells which are not drawn stay transparent. Where a cell is drawn more than once,
+        // the last colour wins.
+        var rgba = [UInt8](repeating: 0, count: width * height * 4)
+        for cell in grid.cells {
+            let index = ((Int(cell.row - minRow) * width) + Int(cell.column - minColumn)) * 4
+            rgba[index] = colorComponent(cell.color.r)
+            rgba[index + 1] = colorComponent(cell.color.g)
+            rgba[index + 2] = colorComponent(cell.color.b)
+            rgba[index + 3] = colorComponent(cell.color.a)
+        }
+        var frame = grid.rect(column: minColumn, row: minRow)
+        frame.size.width *= Float(width)
+        frame.size.height *= Float(height)
+        return EmbeddedImage(frame: frame.normalized, pixelWidth: width, pixelHeight: height, rgba: rgba)
+    }
+
+    private func colorComponent(_ value: Float) -> UInt8 {
+        guard value.isFinite else { return 0 }
+        return UInt8((min(max(value, 0), 1) * 255).rounded())
+    }
+
+    /// Writes an `<image>` element embedding the given pixels as a PNG.
+    /// The frame is in SVG coordinates.
+    func drawEmbeddedImage(_ image: EmbeddedImage) {
+        let png = SVGPNGEncoder.encode(rgba: image.rgba, width: image.pixelWidth, height: image.pixelHeight)
+        beginElement()
+        writer.write(#"<image x=""#)
+        writer.write(number: image.frame.origin.x)
+        writer.write(#"" y=""#)
+        writer.write(number: image.frame.origin.y)
+        writer.write(#"" width=""#)
+        writer.write(number: image.frame.size.width)
+        writer.write(#"" height=""#)
+        writer.write(number: image.frame.size.height)
+        writer.write(#"" preserveAspectRatio="none" style="image-rendering:pixelated" xlink:href="data:image/png;base64,"#)
+        writer.write(base64: png)
+        writer.write(#"" />"#)
+    }
+}
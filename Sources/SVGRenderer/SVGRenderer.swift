@@ -29,12 +29,111 @@ public class SVGRenderer: Renderer{
     var hatchingIncluded = Array(repeating: false,
                                  count: BarGraphSeriesOptions.Hatching.allCases.count)
 
-    var lines: [String] = []
     var fontFamily: String = "Roboto"
 
+    /// How colours are written.
+    public enum ColorFormat {
+        /// `rgb(r,g,b)`, with each component scaled to 0-255 and written as a number.
+        case rgb
+        /// `#rrggbb`, with each component rounded to an integer.
+        case hex
+    }
+
+    /// The number of fractional digits (0-3) written for coordinates, or `nil` to write
+    /// the shortest representation which round-trips. Other values, such as opacities and
+    /// stroke widths, are written with up to 3 fractional digits whenever this is set.
+    ///
+    /// Defaults to `nil` for in-memory rendering and `3` when streaming.
+    public var coordinatePrecision: Int? {
+        didSet {
+            if let precision = coordinatePrecision {
+                precondition((0...SVGWriter.maxFractionDigits).contains(precision),
+                             "SVGRenderer: coordinatePrecision must be between 0 and \(SVGWriter.maxFractionDigits).")
+                writer.numberStyle = .fixed(fractionDigits: precision)
+            } else {
+                writer.numberStyle = .shortest
+            }
+        }
+    }
+
+    /// The format used for fill and stroke colours. Defaults to `.rgb`.
+    public var colorFormat: ColorFormat = .rgb
+
+    /// Whether to use the compact encoding, which is typically several times smaller for
+    /// large charts:
+    ///
+    /// - Polylines and lines become `<path>` elements with relative, delta-encoded commands.
+    /// - Circle and polygon markers are defined once and referenced with `<use>`.
+    /// - Consecutive elements with the same style share a `<g>` with a CSS class.
+    ///
+    /// Coordinates are quantized to `coordinatePrecision` fractional digits (2 if it is `nil`).
+    /// Markers are referenced with `xlink:href`, so the output renders in SVG 1.1 viewers.
+    /// Defaults to `false`.
+    public var compactEncoding = false
+
+    let compactState = SVGCompactEncodingState()
+
+    /// Whether to merge horizontally adjacent solid rects of the same colour, such as
+    /// neighbouring heatmap cells, into a single `<rect>`. Defaults to `false`.
+    public var mergesAdjacentRects = false
+
+    /// If set, consecutive solid rects lying on a regular grid, such as the cells of a
+    /// heatmap, are written as a single embedded PNG `<image>` with one pixel per cell
+    /// once there are at least this many of them. Defaults to `nil`.
+    public var rectGridImageThreshold: Int?
+
+    let rectOptimization = SVGRectOptimizationState()
+
+    /// The clip rect set with `setClipRect`, in SVG coordinates.
+    var clipRect: Rect?
+    /// The number of `<clipPath>` elements written, which numbers their ids.
+    var clipPathCount = 0
+    /// Whether elements are being written into a group clipped to `clipRect`.
+    var isClipGroupOpen = false
+
+    /// If set, text is measured with the advance widths of this font, rather than estimated
+    /// from fixed per-character widths. Use `TrueTypeFontMetrics.bundledFont` to lay out
+    /// text exactly as `AGGRenderer` does. Defaults to `nil`.
+    public var textMetrics: TrueTypeFontMetrics?
+
+    /// Receives the document body when rendering in-memory. `nil` when streaming.
+    private let body: SVGByteBuffer?
+    let writer: SVGWriter
+    private var elementCount = 0
+    private var headerWritten = false
+    private var streamingFinished = false
+
     public init(width w: Float = 1000, height h: Float = 660, fontFamily: String = "Roboto") {
         self.imageSize = Size(width: w, height: h)
         self.fontFamily = fontFamily
+        let body = SVGByteBuffer()
+        self.body = body
+        self.writer = SVGWriter(sink: body, numberStyle: .shortest)
+    }
+
+    /// Creates a renderer which streams the document to `sink` as it is drawn, rather than
+    /// building it in memory. Peak memory is bounded by `bufferCapacity`, regardless of the
+    /// number of elements drawn.
+    ///
+    /// Coordinates are written with at most 3 fractional digits, unless `coordinatePrecision`
+    /// is changed before drawing. The document is completed
+    /// by `finishStreaming()` (or `drawOutput(fileName:)`, which ignores the file name).
+    public init(streamingTo sink: SVGOutputSink,
+                width w: Float = 1000, height h: Float = 660,
+                fontFamily: String = "Roboto",
+                bufferCapacity: Int = 64 * 1024) {
+        self.imageSize = Size(width: w, height: h)
+        self.fontFamily = fontFamily
+        self.body = nil
+        self.coordinatePrecision = SVGWriter.maxFractionDigits
+        self.writer = SVGWriter(sink: sink,
+                                numberStyle: .fixed(fractionDigits: SVGWriter.maxFractionDigits),
+                                capacity: bufferCapacity)
+    }
+
+    /// Whether this renderer writes its document to an `SVGOutputSink` as it is drawn.
+    public var isStreaming: Bool {
+        return body == nil
     }
 
     func convertToSVGCoordinates(_ point: Point) -> Point {
@@ -56,76 +155,87 @@ public class SVGRenderer: Renderer{
                          strokeWidth thickness: Float,
                          strokeColor: Color = Color.black) {
         let rect = convertToSVGCoordinates(rect)
-        let rectStr = #"<rect x="\#(rect.origin.x)" y="\#(rect.origin.y)" width="\#(rect.size.width)" height="\#(rect.size.height)" style="fill:rgb(255,255,255);stroke-width:\#(thickness);stroke:\#(strokeColor.svgColorString);opacity:1;fill-opacity:0;" />"#
-        lines.append(rectStr)
+        guard !isCulled(rect, margin: thickness / 2) else { return }
+        if compactEncoding {
+            drawCompactRect(rect, style: .stroke(strokeColor, width: thickness, isDashed: false))
+            return
+        }
+        beginRect(rect)
+        writer.write(#"fill:rgb(255,255,255);stroke-width:"#)
+        writer.write(scalar: thickness)
+        writer.write(#";stroke:"#)
+        writeColor(strokeColor)
+        writer.write(#";opacity:1;fill-opacity:0;" />"#)
     }
 
     public func drawSolidRect(_ rect: Rect,
                               fillColor: Color = Color.white,
                               hatchPattern: BarGraphSeriesOptions.Hatching) {
         let rect = convertToSVGCoordinates(rect)
-        let rectStr = #"<rect x="\#(rect.origin.x)" y="\#(rect.origin.y)" width="\#(rect.size.width)" height="\#(rect.size.height)" style="fill:\#(fillColor.svgColorString);stroke-width:0;stroke:rgb(0,0,0);opacity:\#(fillColor.a)" />"#
-        lines.append(rectStr)
+        guard !isCulled(rect) else { return }
+        if hatchPattern == .none && optimizesRects {
+            addOptimizedRect(rect, fillColor: fillColor)
+            return
+        }
+        emitSolidRect(rect, fillColor: fillColor)
         drawHatchingRect(rect, hatchPattern: hatchPattern)
     }
 
+    /// Writes a solid rect, given in SVG coordinates.
+    func emitSolidRect(_ rect: Rect, fillColor: Color) {
+        if compactEncoding {
+            drawCompactRect(rect, style: .fill(fillColor))
+            return
+        }
+        beginRect(rect)
+        writer.write(#"fill:"#)
+        writeColor(fillColor)
+        writer.write(#";stroke-width:0;stroke:rgb(0,0,0);opacity:"#)
+        writer.write(scalar: fillColor.a)
+        writer.write(#"" />"#)
+    }
+
     func drawHatchingRect(_ rect: Rect,
                           hatchPattern: BarGraphSeriesOptions.Hatching) {
-        let patternName: String
+        let patternName: StaticString
+        let patternDefinition: String
         switch (hatchPattern) {
         case .none:
             return
         case .forwardSlash:
-            if (!hatchingIncluded[hatchPattern.rawValue]) {
-                lines.append(Self.forwardSlashHatch)
-                hatchingIncluded[hatchPattern.rawValue] = true
-            }
+            patternDefinition = Self.forwardSlashHatch
             patternName = "url(#forwardSlashHatch)"
         case .backwardSlash:
-            if (!hatchingIncluded[hatchPattern.rawValue]) {
-                lines.append(Self.backwardSlashHatch)
-                hatchingIncluded[hatchPattern.rawValue] = true
-            }
+            patternDefinition = Self.backwardSlashHatch
             patternName = "url(#backwardSlashHatch)"
         case .hollowCircle:
-            if (!hatchingIncluded[hatchPattern.rawValue]) {
-                lines.append(Self.hollowCircleHatch)
-                hatchingIncluded[hatchPattern.rawValue] = true
-            }
+            patternDefinition = Self.hollowCircleHatch
             patternName = "url(#hollowCircleHatch)"
         case .filledCircle:
-            if (!hatchingIncluded[hatchPattern.rawValue]) {
-                lines.append(Self.filledCircleHatch)
-                hatchingIncluded[hatchPattern.rawValue] = true
-            }
+            patternDefinition = Self.filledCircleHatch
             patternName = "url(#filledCircleHatch)"
         case .vertical:
-            if (!hatchingIncluded[hatchPattern.rawValue]) {
-                lines.append(Self.verticalHatch)
-                hatchingIncluded[hatchPattern.rawValue] = true
-            }
+            patternDefinition = Self.verticalHatch
             patternName = "url(#verticalHatch)"
         case .horizontal:
-            if (!hatchingIncluded[hatchPattern.rawValue]) {
-                lines.append(Self.horizontalHatch)
-                hatchingIncluded[hatchPattern.rawValue] = true
-            }
+            patternDefinition = Self.horizontalHatch
             patternName = "url(#horizontalHatch)"
         case .grid:
-            if (!hatchingIncluded[hatchPattern.rawValue]) {
-                lines.append(Self.gridHatch)
-                hatchingIncluded[hatchPattern.rawValue] = true
-            }
+            patternDefinition = Self.gridHatch
             patternName = "url(#gridHatch)"
         case .cross:
-            if (!hatchingIncluded[hatchPattern.rawValue]) {
-                lines.append(Self.crossHatch)
-                hatchingIncluded[hatchPattern.rawValue] = true
-            }
+            patternDefinition = Self.crossHatch
             patternName = "url(#crossHatch)"
         }
-        let rectStr = #"<rect x="\#(rect.origin.x)" y="\#(rect.origin.y)" width="\#(rect.size.width)" height="\#(rect.size.height)" style="fill:\#(patternName);opacity:\#(1)" />"#
-        lines.append(rectStr)
+        if (!hatchingIncluded[hatchPattern.rawValue]) {
+            beginElement()
+            writer.write(string: patternDefinition)
+            hatchingIncluded[hatchPattern.rawValue] = true
+        }
+        beginRect(rect)
+        writer.write(#"fill:"#)
+        writer.write(patternName)
+        writer.write(#";opacity:1" />"#)
     }
 
     public func drawSolidRectWithBorder(_ rect: Rect,
@@ -133,16 +243,44 @@ public class SVGRenderer: Renderer{
                                         fillColor: Color = Color.white,
                                         borderColor: Color = Color.black) {
         let rect = convertToSVGCoordinates(rect)
-        let rectStr = #"<rect x="\#(rect.origin.x)" y="\#(rect.origin.y)" width="\#(rect.size.width)" height="\#(rect.size.height)" style="fill:\#(fillColor.svgColorString);stroke-width:\#(thickness);stroke:\#(borderColor.svgColorString);opacity:\#(fillColor.a)" />"#
-        lines.append(rectStr)
+        guard !isCulled(rect, margin: thickness / 2) else { return }
+        if compactEncoding {
+            drawCompactRect(rect, style: .fillAndStroke(fillColor, borderColor, width: thickness))
+            return
+        }
+        beginRect(rect)
+        writer.write(#"fill:"#)
+        writeColor(fillColor)
+        writer.write(#";stroke-width:"#)
+        writer.write(scalar: thickness)
+        writer.write(#";stroke:"#)
+        writeColor(borderColor)
+        writer.write(#";opacity:"#)
+        writer.write(scalar: fillColor.a)
+        writer.write(#"" />"#)
     }
 
     public func drawSolidCircle(center c: Point,
                                 radius r: Float,
                                 fillColor: Color) {
         let c = convertToSVGCoordinates(c)
-        let circle: String = #"<circle cx="\#(c.x)" cy="\#(c.y)" r="\#(r)"  style="fill:\#(fillColor.svgColorString);opacity:\#(fillColor.a)" />"#
-        lines.append(circle)
+        guard !isCulled(Rect(origin: c, size: .zero), margin: r) else { return }
+        if compactEncoding {
+            drawCompactCircle(center: c, radius: r, fillColor: fillColor)
+            return
+        }
+        beginElement()
+        writer.write(#"<circle cx=""#)
+        writer.write(number: c.x)
+        writer.write(#"" cy=""#)
+        writer.write(number: c.y)
+        writer.write(#"" r=""#)
+        writer.write(number: r)
+        writer.write(#""  style="fill:"#)
+        writeColor(fillColor)
+        writer.write(#";opacity:"#)
+        writer.write(scalar: fillColor.a)
+        writer.write(#"" />"#)
     }
 
     public func drawSolidEllipse(center c: Point,
@@ -150,8 +288,27 @@ public class SVGRenderer: Renderer{
                                  radiusY ry: Float,
                                  fillColor: Color) {
         let c = convertToSVGCoordinates(c)
-        let circle: String = #"<ellipse cx="\#(c.x)" cy="\#(c.y)" rx="\#(rx)" ry="\#(ry)" style="fill:\#(fillColor.svgColorString);opacity:\#(fillColor.a)" />"#
-        lines.append(circle)
+        guard !isCulled(Rect(origin: Point(c.x - rx, c.y - ry), size: Size(width: 2 * rx, height: 2 * ry))) else {
+            return
+        }
+        if compactEncoding {
+            drawCompactEllipse(center: c, radiusX: rx, radiusY: ry, fillColor: fillColor)
+            return
+        }
+        beginElement()
+        writer.write(#"<ellipse cx=""#)
+        writer.write(number: c.x)
+        writer.write(#"" cy=""#)
+        writer.write(number: c.y)
+        writer.write(#"" rx=""#)
+        writer.write(number: rx)
+        writer.write(#"" ry=""#)
+        writer.write(number: ry)
+        writer.write(#"" style="fill:"#)
+        writeColor(fillColor)
+        writer.write(#";opacity:"#)
+        writer.write(scalar: fillColor.a)
+        writer.write(#"" />"#)
     }
 
     public func drawSolidTriangle(point1: Point,
@@ -161,20 +318,44 @@ public class SVGRenderer: Renderer{
         let p1 = convertToSVGCoordinates(point1)
         let p2 = convertToSVGCoordinates(point2)
         let p3 = convertToSVGCoordinates(point3)
-        let triangle = #"<polygon points="\#(p1.x),\#(p1.y) \#(p2.x),\#(p2.y) \#(p3.x),\#(p3.y)" style="fill:\#(fillColor.svgColorString);opacity:\#(fillColor.a)" />"#
-        lines.append(triangle)
+        guard !isCulled([p1, p2, p3]) else { return }
+        if compactEncoding {
+            drawCompactPolygon([p1, p2, p3], fillColor: fillColor)
+            return
+        }
+        beginElement()
+        writer.write(#"<polygon points=""#)
+        writePoint(p1)
+        writer.write(byte: UInt8(ascii: " "))
+        writePoint(p2)
+        writer.write(byte: UInt8(ascii: " "))
+        writePoint(p3)
+        writer.write(#"" style="fill:"#)
+        writeColor(fillColor)
+        writer.write(#";opacity:"#)
+        writer.write(scalar: fillColor.a)
+        writer.write(#"" />"#)
     }
     
     public func drawSolidPolygon(_ polygon: SwiftPlot.Polygon,
                                  fillColor: Color) {
-        var pointsString = ""
-        for point in polygon.points {
-            let convertedPoint = convertToSVGCoordinates(point)
-            pointsString.append("\(convertedPoint.x),\(convertedPoint.y) ")
+        let points = polygon.points.map { convertToSVGCoordinates($0) }
+        guard !isCulled(points) else { return }
+        if compactEncoding {
+            drawCompactPolygon(points, fillColor: fillColor)
+            return
         }
-        
-        let polygonString = #"<polygon points="\#(pointsString)" style="fill:\#(fillColor.svgColorString);opacity:\#(fillColor.a)" />"#
-        lines.append(polygonString)
+        beginElement()
+        writer.write(#"<polygon points=""#)
+        for point in points {
+            writePoint(point)
+            writer.write(byte: UInt8(ascii: " "))
+        }
+        writer.write(#"" style="fill:"#)
+        writeColor(fillColor)
+        writer.write(#";opacity:"#)
+        writer.write(scalar: fillColor.a)
+        writer.write(#"" />"#)
     }
 
     public func drawLine(startPoint p1: Point,
@@ -184,28 +365,90 @@ public class SVGRenderer: Renderer{
                          isDashed: Bool) {
         let p1 = convertToSVGCoordinates(p1)
         let p2 = convertToSVGCoordinates(p2)
-        var line : String
+        guard !isCulled([p1, p2], margin: thickness / 2) else { return }
+        if compactEncoding {
+            drawCompactLine(from: p1, to: p2,
+                            style: .stroke(strokeColor, width: thickness, isDashed: isDashed))
+            return
+        }
+        beginElement()
+        writer.write(#"<line x1=""#)
+        writer.write(number: p1.x)
+        writer.write(#"" y1=""#)
+        writer.write(number: p1.y)
+        writer.write(#"" x2=""#)
+        writer.write(number: p2.x)
+        writer.write(#"" y2=""#)
+        writer.write(number: p2.y)
+        writer.write(#"" style="stroke:"#)
+        writeColor(strokeColor)
+        writer.write(#";stroke-width:"#)
+        writer.write(scalar: thickness)
+        writer.write(#";opacity:"#)
+        writer.write(scalar: strokeColor.a)
         if (isDashed) {
-            line = #"<line x1="\#(p1.x)" y1="\#(p1.y)" x2="\#(p2.x)" y2="\#(p2.y)" style="stroke:\#(strokeColor.svgColorString);stroke-width:\#(thickness);opacity:\#(strokeColor.a);stroke-linecap:butt;stroke-dasharray:4 1" />"#
+            writer.write(#";stroke-linecap:butt;stroke-dasharray:4 1" />"#)
         }
         else {
-            line = #"<line x1="\#(p1.x)" y1="\#(p1.y)" x2="\#(p2.x)" y2="\#(p2.y)" style="stroke:\#(strokeColor.svgColorString);stroke-width:\#(thickness);opacity:\#(strokeColor.a);stroke-linecap:butt" />"#
+            writer.write(#";stroke-linecap:butt" />"#)
         }
-        lines.append(line)
     }
 
     public func drawPolyline(_ polyline: Polyline,
                               strokeWidth thickness: Float,
                               strokeColor: Color,
                               isDashed: Bool) {
-        let pointsString = polyline.points.lazy.map { point in
-            let convertedPoint = self.convertToSVGCoordinates(point)
-            return "\(convertedPoint.x),\(convertedPoint.y)"
-        }.joined(separator: " ")
-
-        let dashedString = isDashed ? "stroke-dasharray:4 1;" : ""
+        let points = polyline.points.map { convertToSVGCoordinates($0) }
+        guard clipRect != nil else {
+            drawPolylineRun(polyline, points: points,
+                            strokeWidth: thickness, strokeColor: strokeColor, isDashed: isDashed)
+            return
+        }
+        // Miter joins reach up to twice the stroke width from their vertex.
+        if isDashed {
+            // Splitting a dashed polyline would restart its dash pattern.
+            guard !isCulled(points, margin: 2 * thickness) else { return }
+            drawPolylineRun(polyline, points: points,
+                            strokeWidth: thickness, strokeColor: strokeColor, isDashed: isDashed)
+            return
+        }
+        for run in visibleRuns(of: points, margin: 2 * thickness) {
+            let runPolyline = run.count == points.count ? polyline : Polyline(Array(polyline.points[run]))!
+            drawPolylineRun(runPolyline, points: Array(points[run]),
+                            strokeWidth: thickness, strokeColor: strokeColor, isDashed: isDashed)
+        }
+    }
 
-        lines.append(#"<polyline points="\#(pointsString)" style="stroke:\#(strokeColor.svgColorString);stroke-width:\#(thickness);opacity:\#(strokeColor.a);stroke-linecap:butt;fill:none;\#(dashedString)" />"#)
+    /// Writes a polyline, whose points have already been converted to SVG coordinates as `points`.
+    private func drawPolylineRun(_ polyline: Polyline,
+                                 points: [Point],
+                                 strokeWidth thickness: Float,
+                                 strokeColor: Color,
+                                 isDashed: Bool) {
+        if compactEncoding {
+            drawCompactPolyline(polyline,
+                                style: .stroke(strokeColor, width: thickness, isDashed: isDashed))
+            return
+        }
+        beginElement()
+        writer.write(#"<polyline points=""#)
+        var isFirstPoint = true
+        for point in points {
+            if !isFirstPoint { writer.write(byte: UInt8(ascii: " ")) }
+            writePoint(point)
+            isFirstPoint = false
+        }
+        writer.write(#"" style="stroke:"#)
+        writeColor(strokeColor)
+        writer.write(#";stroke-width:"#)
+        writer.write(scalar: thickness)
+        writer.write(#";opacity:"#)
+        writer.write(scalar: strokeColor.a)
+        writer.write(#";stroke-linecap:butt;fill:none;"#)
+        if isDashed {
+            writer.write(#"stroke-dasharray:4 1;"#)
+        }
+        writer.write(#"" />"#)
     }
 
     public func drawText(text s: String,
@@ -215,11 +458,36 @@ public class SVGRenderer: Renderer{
                          strokeWidth thickness: Float,
                          angle: Float){
         let p = convertToSVGCoordinates(p)
-        let text = #"<text font-size="\#(size)" font-family="\#(fontFamily)" x="\#(p.x)" y="\#(p.y)" style="stroke:\#(color.svgColorString);stroke-width:\#(thickness/4);fill:\#(color.svgColorString);opacity:\#(color.a);" transform="rotate(\#(-angle),\#(p.x),\#(p.y))">\#(s)</text>"#
-        lines.append(text)
+        beginElement()
+        writer.write(#"<text font-size=""#)
+        writer.write(scalar: size)
+        writer.write(#"" font-family=""#)
+        writer.write(string: fontFamily)
+        writer.write(#"" x=""#)
+        writer.write(number: p.x)
+        writer.write(#"" y=""#)
+        writer.write(number: p.y)
+        writer.write(#"" style="stroke:"#)
+        writeColor(color)
+        writer.write(#";stroke-width:"#)
+        writer.write(scalar: thickness/4)
+        writer.write(#";fill:"#)
+        writeColor(color)
+        writer.write(#";opacity:"#)
+        writer.write(scalar: color.a)
+        writer.write(#";" transform="rotate("#)
+        writer.write(scalar: -angle)
+        writer.write(byte: UInt8(ascii: ","))
+        writePoint(p)
+        writer.write(#")">"#)
+        writer.write(string: s)
+        writer.write(#"</text>"#)
     }
 
     public func getTextLayoutSize(text: String, textSize size: Float) -> Size {
+        if let metrics = textMetrics {
+            return metrics.measure(text, size: size)
+        }
         let width = text.reduce(into: Float(0)) { width, character in
             guard let asciiVal = character.ascii else { return }
             width += Float(Self.LCARS_CHAR_SIZE_ARRAY[Int(asciiVal)])
@@ -228,32 +496,146 @@ public class SVGRenderer: Renderer{
         return Size(width: width*scaleFactor + 25, height: size)
     }
 
+    public var fontIdentifier: String {
+        guard let metrics = textMetrics else { return "" }
+        return "TrueTypeFontMetrics-\(ObjectIdentifier(metrics).hashValue)-\(metrics.usesKerning)"
+    }
+
     public func drawOutput(fileName name: String) throws {
-        try savePlotImage(fileName: name)
+        if isStreaming {
+            finishStreaming()
+        } else {
+            try savePlotImage(fileName: name)
+        }
+    }
+
+    /// Completes a streamed document and flushes it to the sink.
+    /// Elements drawn after the document has been finished are discarded.
+    public func finishStreaming() {
+        guard isStreaming, !streamingFinished else { return }
+        if !headerWritten {
+            writeHeader(to: writer)
+            headerWritten = true
+        }
+        flushPendingRects()
+        endCompactGroup()
+        writeFooter(to: writer)
+        writer.flush()
+        streamingFinished = true
     }
     
-    /// Returns the content of the SVG generated by the renderer
+    /// Returns the content of the SVG generated by the renderer.
+    /// Streaming renderers do not retain their output, so for them this is always empty.
     public var svg: String {
-            // Build the document.
-            let header = #"<svg height="\#(imageSize.height)" width="\#(imageSize.width)" version="4.0" xmlns="http://www.w3.org/2000/svg" xmlns:xlink= "http://www.w3.org/1999/xlink">"#
-                + "\n" + #"<rect width="100%" height="100%" fill="white"/>"#
-            let font = #"<defs><style>@import url("https://fonts.googleapis.com/css?family=\#(fontFamily)");</style></defs>"#
-            let image = header + "\n" + font + "\n" + lines.joined(separator: "\n") + "\n</svg>"
-            return image
+        return String(decoding: documentBytes(), as: UTF8.self)
     }
 
     func savePlotImage(fileName name: String) throws {
         // Build the document.
-        let image = self.svg
+        let image = Data(documentBytes())
 
         let url = URL(fileURLWithPath: "\(name).svg")
-        try image.write(to: url, atomically: true, encoding: .utf8)
+        try image.write(to: url, options: .atomic)
     }
 
-}
+    /// Builds the complete in-memory document.
+    private func documentBytes() -> [UInt8] {
+        guard let body = body else { return [] }
+        flushPendingRects()
+        endCompactGroup()
+        writer.flush()
+        let document = SVGByteBuffer(minimumCapacity: body.count + 512)
+        do {
+            let documentWriter = SVGWriter(sink: document, numberStyle: writer.numberStyle, capacity: 512)
+            writeHeader(to: documentWriter)
+            body.bytes.withUnsafeBytes { documentWriter.write($0) }
+            writeFooter(to: documentWriter)
+            documentWriter.flush()
+        }
+        return document.bytes
+    }
+
+    // MARK: Serialization helpers.
+
+    private func writeHeader(to writer: SVGWriter) {
+        writer.write(#"<svg height=""#)
+        writer.write(number: imageSize.height)
+        writer.write(#"" width=""#)
+        writer.write(number: imageSize.width)
+        writer.write(#"" version="4.0" xmlns="http://www.w3.org/2000/svg" xmlns:xlink= "http://www.w3.org/1999/xlink">"#)
+        writer.write("\n")
+        writer.write(#"<rect width="100%" height="100%" fill="white"/>"#)
+        writer.write("\n")
+        writer.write(#"<defs><style>@import url("https://fonts.googleapis.com/css?family="#)
+        writer.write(string: fontFamily)
+        writer.write(#"");</style></defs>"#)
+        writer.write("\n")
+    }
+
+    private func writeFooter(to writer: SVGWriter) {
+        if isClipGroupOpen {
+            writer.write("\n</g>")
+        }
+        writer.write("\n</svg>")
+    }
+
+    /// Starts a new element, separating it from the previous one. Unless the element is
+    /// part of a compact-encoding group, any open group is closed first.
+    func beginElement(inGroup: Bool = false) {
+        flushPendingRects()
+        if isStreaming && !headerWritten {
+            writeHeader(to: writer)
+            headerWritten = true
+        }
+        if !inGroup && compactState.openGroup != nil {
+            endCompactGroup()
+        }
+        if elementCount > 0 {
+            writer.write(byte: UInt8(ascii: "\n"))
+        }
+        elementCount += 1
+    }
+
+    /// Writes the opening of a `<rect>` element, up to and including `style="`.
+    private func beginRect(_ rect: Rect) {
+        beginElement()
+        writer.write(#"<rect x=""#)
+        writer.write(number: rect.origin.x)
+        writer.write(#"" y=""#)
+        writer.write(number: rect.origin.y)
+        writer.write(#"" width=""#)
+        writer.write(number: rect.size.width)
+        writer.write(#"" height=""#)
+        writer.write(number: rect.size.height)
+        writer.write(#"" style=""#)
+    }
+
+    private func writePoint(_ point: Point) {
+        writer.write(number: point.x)
+        writer.write(byte: UInt8(ascii: ","))
+        writer.write(number: point.y)
+    }
+
+    func writeColor(_ color: Color) {
+        switch colorFormat {
+        case .rgb:
+            writer.write("rgb(")
+            writer.write(scalar: color.r*255.0)
+            writer.write(byte: UInt8(ascii: ","))
+            writer.write(scalar: color.g*255.0)
+            writer.write(byte: UInt8(ascii: ","))
+            writer.write(scalar: color.b*255.0)
+            writer.write(byte: UInt8(ascii: ")"))
+        case .hex:
+            writer.write(byte: UInt8(ascii: "#"))
+            writer.write(hexByte: hexComponent(color.r))
+            writer.write(hexByte: hexComponent(color.g))
+            writer.write(hexByte: hexComponent(color.b))
+        }
+    }
 
-extension Color {
-    var svgColorString: String {
-        return "rgb(\(r*255.0),\(g*255.0),\(b*255.0))"
+    private func hexComponent(_ value: Float) -> UInt8 {
+        guard value.isFinite else { return 0 }
+        return UInt8((min(max(value, 0), 1) * 255).rounded())
     }
 }
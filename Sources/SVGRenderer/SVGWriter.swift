@@ -0,0 +1,231 @@
+import Foundation
+
+/// Serializes SVG markup as UTF-8 into a fixed-size buffer which is flushed to an
+/// `SVGOutputSink` whenever it fills up.
+///
+/// Numbers are written either with Swift's shortest round-trip `description` (which
+/// is what `SVGRenderer` has always produced) or with a hand-rolled fixed-precision
+/// formatter which generates digits, two at a time, straight into the buffer.
+final class SVGWriter {
+
+    enum NumberStyle: Equatable {
+        /// `Float.description`, e.g. `123.45678`.
+        case shortest
+        /// At most `fractionDigits` (0-3) fractional digits, trailing zeros removed,
+        /// e.g. `123.457`.
+        case fixed(fractionDigits: Int)
+    }
+
+    let sink: SVGOutputSink
+    /// The style used for coordinates.
+    var numberStyle: NumberStyle
+
+    private let buffer: UnsafeMutablePointer<UInt8>
+    private let capacity: Int
+    private var count = 0
+
+    /// The largest number of bytes a single number can occupy.
+    private static let maxNumberLength = 48
+    /// The most fractional digits the fixed-precision formatter supports.
+    static let maxFractionDigits = 3
+
+    private static let powersOfTen: [UInt64] = [1, 10, 100, 1000]
+    /// The ASCII digits of 00 through 99.
+    private static let digitPairs: [UInt8] = (0..<100).flatMap {
+        [UInt8(ascii: "0") + UInt8($0 / 10), UInt8(ascii: "0") + UInt8($0 % 10)]
+    }
+    private static let hexDigits: [UInt8] = Array("0123456789abcdef".utf8)
+
+    init(sink: SVGOutputSink, numberStyle: NumberStyle, capacity: Int = 64 * 1024) {
+        self.sink = sink
+        self.numberStyle = numberStyle
+        self.capacity = max(capacity, SVGWriter.maxNumberLength)
+        self.buffer = UnsafeMutablePointer<UInt8>.allocate(capacity: self.capacity)
+    }
+
+    deinit {
+        flush()
+        buffer.deallocate()
+    }
+
+    /// Hands any buffered bytes to the sink.
+    func flush() {
+        guard count > 0 else { return }
+        sink.write(UnsafeRawBufferPointer(start: buffer, count: count))
+        count = 0
+    }
+
+    @inline(__always)
+    private func reserve(_ n: Int) {
+        if capacity - count < n { flush() }
+    }
+
+    func write(_ bytes: UnsafeRawBufferPointer) {
+        guard let base = bytes.baseAddress, bytes.count > 0 else { return }
+        if bytes.count > capacity - count {
+            flush()
+            // Too large to be worth buffering.
+            if bytes.count > capacity {
+                sink.write(bytes)
+                return
+            }
+        }
+        UnsafeMutableRawPointer(buffer + count).copyMemory(from: base, byteCount: bytes.count)
+        count += bytes.count
+    }
+
+    @inline(__always)
+    func write(byte: UInt8) {
+        reserve(1)
+        buffer[count] = byte
+        count += 1
+    }
+
+    func write(_ string: StaticString) {
+        string.withUTF8Buffer { write(UnsafeRawBufferPointer($0)) }
+    }
+
+    func write(string: String) {
+        var string = string
+        string.withUTF8 { write(UnsafeRawBufferPointer($0)) }
+    }
+
+    /// Writes a coordinate, in the current `numberStyle`.
+    func write(number value: Float) {
+        switch numberStyle {
+        case .shortest:
+            // Float descriptions fit in a small string, so this does not allocate.
+            write(string: value.description)
+        case .fixed(let fractionDigits):
+            writeFixed(value, fractionDigits: fractionDigits)
+        }
+    }
+
+    /// Writes a value which is not a coordinate, such as an opacity or a stroke width.
+    /// These keep the maximum precision regardless of the coordinate precision, so that
+    /// e.g. an opacity of `0.25` is not rounded away.
+    func write(scalar value: Float) {
+        switch numberStyle {
+        case .shortest:
+            write(string: value.description)
+        case .fixed:
+            writeFixed(value, fractionDigits: SVGWriter.maxFractionDigits)
+        }
+    }
+
+    /// Writes `value` as two lowercase hexadecimal digits.
+    func write(hexByte value: UInt8) {
+        reserve(2)
+        buffer[count] = SVGWriter.hexDigits[Int(value >> 4)]
+        buffer[count + 1] = SVGWriter.hexDigits[Int(value & 0xF)]
+        count += 2
+    }
+
+    private static let base64Digits: [UInt8] =
+        Array("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/".utf8)
+
+    /// Writes `bytes` encoded as base64, without line breaks.
+    func write(base64 bytes: [UInt8]) {
+        let digits = SVGWriter.base64Digits
+        var index = 0
+        while index < bytes.count {
+            let remaining = bytes.count - index
+            let b0 = UInt32(bytes[index])
+            let b1 = remaining > 1 ? UInt32(bytes[index + 1]) : 0
+            let b2 = remaining > 2 ? UInt32(bytes[index + 2]) : 0
+            let group = (b0 << 16) | (b1 << 8) | b2
+            reserve(4)
+            buffer[count] = digits[Int((group >> 18) & 0x3F)]
+            buffer[count + 1] = digits[Int((group >> 12) & 0x3F)]
+            buffer[count + 2] = remaining > 1 ? digits[Int((group >> 6) & 0x3F)] : UInt8(ascii: "=")
+            buffer[count + 3] = remaining > 2 ? digits[Int(group & 0x3F)] : UInt8(ascii: "=")
+            count += 4
+            index += 3
+        }
+    }
+
+    // MARK: Fixed-precision formatting.
+
+    private func writeFixed(_ value: Float, fractionDigits: Int) {
+        let magnitude = Double(value).magnitude
+        // Non-finite and enormous values are rare enough to not be worth formatting by hand.
+        guard value.isFinite, magnitude < 1e15 else {
+            write(string: value.description)
+            return
+        }
+        let scaled = UInt64((magnitude * Double(SVGWriter.powersOfTen[fractionDigits])).rounded())
+        writeScaled(scaled, isNegative: value < 0, fractionDigits: fractionDigits)
+    }
+
+    /// Rounds `value` to an integer number of `10^-fractionDigits` units, for writing with
+    /// `write(quantized:fractionDigits:)`. Quantized values can be subtracted without
+    /// accumulating rounding error.
+    static func quantize(_ value: Float, fractionDigits: Int) -> Int64 {
+        let scaled = (Double(value) * Double(powersOfTen[fractionDigits])).rounded()
+        guard scaled.isFinite else { return 0 }
+        return Int64(min(max(scaled, -1e15), 1e15))
+    }
+
+    /// Writes a value in units of `10^-fractionDigits`, as produced by `quantize`.
+    func write(quantized value: Int64, fractionDigits: Int) {
+        writeScaled(value.magnitude, isNegative: value < 0, fractionDigits: fractionDigits)
+    }
+
+    private func writeScaled(_ scaled: UInt64, isNegative: Bool, fractionDigits: Int) {
+        guard scaled != 0 else {
+            write(byte: UInt8(ascii: "0"))
+            return
+        }
+        reserve(SVGWriter.maxNumberLength)
+        if isNegative {
+            buffer[count] = UInt8(ascii: "-")
+            count += 1
+        }
+        let divisor = SVGWriter.powersOfTen[fractionDigits]
+        writeDigits(scaled / divisor)
+        var fraction = scaled % divisor
+        guard fraction != 0 else { return }
+        buffer[count] = UInt8(ascii: ".")
+        count += 1
+        // Write all of the fractional digits, zero-padded, then drop trailing zeros.
+        var index = count + fractionDigits
+        for _ in 0..<fractionDigits {
+            index -= 1
+            buffer[index] = UInt8(ascii: "0") &+ UInt8(truncatingIfNeeded: fraction % 10)
+            fraction /= 10
+        }
+        count += fractionDigits
+        while buffer[count - 1] == UInt8(ascii: "0") {
+            count -= 1
+        }
+    }
+
+    /// Writes the decimal digits of `value`. Space must already have been reserved.
+    private func writeDigits(_ value: UInt64) {
+        var length = 1
+        var remaining = value
+        while remaining >= 100 {
+            remaining /= 100
+            length += 2
+        }
+        if remaining >= 10 { length += 1 }
+
+        var index = count + length
+        remaining = value
+        while remaining >= 100 {
+            let pair = Int(remaining % 100) &* 2
+            remaining /= 100
+            index -= 2
+            buffer[index] = SVGWriter.digitPairs[pair]
+            buffer[index + 1] = SVGWriter.digitPairs[pair + 1]
+        }
+        if remaining >= 10 {
+            let pair = Int(remaining) &* 2
+            buffer[index - 2] = SVGWriter.digitPairs[pair]
+            buffer[index - 1] = SVGWriter.digitPairs[pair + 1]
+        } else {
+            buffer[index - 1] = UInt8(ascii: "0") &+ UInt8(truncatingIfNeeded: remaining)
+        }
+        count += length
+    }
+}
@@ -0,0 +1,300 @@
+import Foundation
+import SwiftPlot
+
+/// Measures text using the metrics in a TrueType font file, without rasterizing any glyphs.
+///
+/// The font is parsed once into compact tables: an advance width and vertical bounds per
+/// glyph, a character map, and the pairs from the `kern` table. Advances are scaled with
+/// the same fixed-point arithmetic as FreeType, so widths match `AGGRenderer`'s for the
+/// same font. Measured strings are cached.
+public final class TrueTypeFontMetrics {
+
+    public enum Error: Swift.Error, CustomStringConvertible {
+        case missingTable(String)
+        case malformedFont(String)
+
+        public var description: String {
+            switch self {
+            case .missingTable(let tag): return "Font has no '\(tag)' table"
+            case .malformedFont(let detail): return "Malformed font: \(detail)"
+            }
+        }
+    }
+
+    public let unitsPerEm: Int
+
+    /// Whether pairs from the font's `kern` table are applied. Defaults to `false`, which
+    /// matches `AGGRenderer`. Fonts which only have GPOS kerning are not kerned.
+    public var usesKerning: Bool {
+        get {
+            lock.lock(); defer { lock.unlock() }
+            return _usesKerning
+        }
+        set {
+            lock.lock(); defer { lock.unlock() }
+            if _usesKerning != newValue { cache.removeAll() }
+            _usesKerning = newValue
+        }
+    }
+
+    private let advances: [UInt16]
+    private let glyphYMin: [Int16]
+    private let glyphYMax: [Int16]
+    private let asciiGlyphs: [UInt16]
+    private let glyphs: [UInt32: UInt16]
+    private let kerningPairs: [UInt32: Int16]
+
+    private struct CacheKey: Hashable {
+        var text: String
+        var size: Float
+    }
+    private static let cacheLimit = 4096
+    private var cache: [CacheKey: Size] = [:]
+    private var _usesKerning = false
+    private let lock = NSLock()
+
+    /// The Roboto font bundled with `AGGRenderer`, or `nil` if the package sources are not
+    /// available at runtime.
+    public static let bundledFont: TrueTypeFontMetrics? = {
+        // #file = Sources/SVGRenderer/TrueTypeFontMetrics.swift
+        var fontURL = URL(fileURLWithPath: #file)
+        fontURL.deleteLastPathComponent() // TrueTypeFontMetrics.swift
+        fontURL.deleteLastPathComponent() // SVGRenderer
+        fontURL.appendPathComponent("AGGRenderer/CPPAGGRenderer/Roboto-Regular.ttf")
+        return try? TrueTypeFontMetrics(contentsOf: fontURL)
+    }()
+
+    public convenience init(contentsOf url: URL) throws {
+        try self.init(data: try Data(contentsOf: url))
+    }
+
+    public init(data: Data) throws {
+        let font = FontReader(bytes: [UInt8](data))
+        let tables = try font.tableDirectory()
+        func table(_ tag: String) throws -> Int {
+            guard let offset = tables[tag] else { throw Error.missingTable(tag) }
+            return offset
+        }
+
+        let head = try table("head")
+        unitsPerEm = Int(try font.u16(head + 18))
+        guard unitsPerEm > 0 else { throw Error.malformedFont("unitsPerEm is 0") }
+        let usesLongOffsets = try font.i16(head + 50) != 0
+        let glyphCount = Int(try font.u16(try table("maxp") + 4))
+        let metricCount = Int(try font.u16(try table("hhea") + 34))
+        guard metricCount > 0 else { throw Error.malformedFont("no horizontal metrics") }
+
+        // hmtx: glyphs after the last metric share its advance.
+        let hmtx = try table("hmtx")
+        var advances = [UInt16](repeating: 0, count: glyphCount)
+        for glyph in 0..<glyphCount {
+            advances[glyph] = try font.u16(hmtx + 4 * min(glyph, metricCount - 1))
+        }
+        self.advances = advances
+
+        // loca/glyf: only the vertical extent of each glyph is kept.
+        var glyphYMin = [Int16](repeating: 0, count: glyphCount)
+        var glyphYMax = [Int16](repeating: 0, count: glyphCount)
+        if let loca = tables["loca"], let glyf = tables["glyf"] {
+            func glyphOffset(_ glyph: Int) throws -> Int {
+                return usesLongOffsets ? Int(try font.u32(loca + 4 * glyph))
+                                       : Int(try font.u16(loca + 2 * glyph)) * 2
+            }
+            for glyph in 0..<glyphCount {
+                let start = try glyphOffset(glyph)
+                guard try glyphOffset(glyph + 1) > start else { continue }
+                glyphYMin[glyph] = try font.i16(glyf + start + 4)
+                glyphYMax[glyph] = try font.i16(glyf + start + 8)
+            }
+        }
+        self.glyphYMin = glyphYMin
+        self.glyphYMax = glyphYMax
+
+        let glyphs = try font.characterMap(at: try table("cmap"), glyphCount: glyphCount)
+        self.glyphs = glyphs
+        self.asciiGlyphs = (0..<128).map { glyphs[UInt32($0)] ?? 0 }
+
+        self.kerningPairs = try tables["kern"].map { try font.kerningPairs(at: $0) } ?? [:]
+    }
+
+    /// Returns the size of `text` at the given font size, in pixels.
+    ///
+    /// The width is the sum of the glyph advances; the height spans the glyphs' outlines
+    /// and the baseline.
+    public func measure(_ text: String, size: Float) -> Size {
+        let key = CacheKey(text: text, size: size)
+        lock.lock()
+        if let cached = cache[key] {
+            lock.unlock()
+            return cached
+        }
+        let usesKerning = _usesKerning
+        lock.unlock()
+
+        let measured = measureUncached(text, size: size, usesKerning: usesKerning)
+
+        lock.lock()
+        if cache.count >= TrueTypeFontMetrics.cacheLimit { cache.removeAll(keepingCapacity: true) }
+        cache[key] = measured
+        lock.unlock()
+        return measured
+    }
+
+    private func measureUncached(_ text: String, size: Float, usesKerning: Bool) -> Size {
+        // FreeType scales font units to 26.6 fixed-point pixels with a 16.16 scale factor.
+        let charSize = Int64(max(size, 0) * 64)
+        let scale = ((charSize << 16) + Int64(unitsPerEm / 2)) / Int64(unitsPerEm)
+        func scaled(_ units: Int64) -> Int64 {
+            let product = units.magnitude * scale.magnitude + 0x8000
+            let result = Int64(product >> 16)
+            return units < 0 ? -result : result
+        }
+
+        var width: Int64 = 0
+        var yMin: Int16 = 0
+        var yMax: Int16 = 0
+        var previousGlyph: UInt16?
+        for scalar in text.unicodeScalars {
+            let glyph = self.glyph(for: scalar.value)
+            width += scaled(Int64(advances[Int(glyph)]))
+            if usesKerning, let previous = previousGlyph,
+               let kerning = kerningPairs[UInt32(previous) << 16 | UInt32(glyph)] {
+                width += scaled(Int64(kerning))
+            }
+            yMin = min(yMin, glyphYMin[Int(glyph)])
+            yMax = max(yMax, glyphYMax[Int(glyph)])
+            previousGlyph = glyph
+        }
+        let pixelsPerUnit = size / Float(unitsPerEm)
+        let height = (Float(yMax) * pixelsPerUnit).rounded(.up) - (Float(yMin) * pixelsPerUnit).rounded(.down)
+        return Size(width: Float(width) / 64, height: height)
+    }
+
+    private func glyph(for codePoint: UInt32) -> UInt16 {
+        if codePoint < 128 { return asciiGlyphs[Int(codePoint)] }
+        return glyphs[codePoint] ?? 0
+    }
+}
+
+// MARK: - Parsing.
+
+/// Big-endian, bounds-checked reads from a font file.
+private struct FontReader {
+    let bytes: [UInt8]
+
+    func u16(_ offset: Int) throws -> UInt16 {
+        guard offset >= 0, offset + 2 <= bytes.count else { throw outOfBounds(offset) }
+        return UInt16(bytes[offset]) << 8 | UInt16(bytes[offset + 1])
+    }
+
+    func i16(_ offset: Int) throws -> Int16 {
+        return Int16(bitPattern: try u16(offset))
+    }
+
+    func u32(_ offset: Int) throws -> UInt32 {
+        return UInt32(try u16(offset)) << 16 | UInt32(try u16(offset + 2))
+    }
+
+    private func outOfBounds(_ offset: Int) -> TrueTypeFontMetrics.Error {
+        return .malformedFont("read at offset \(offset) is out of bounds")
+    }
+
+    /// Maps table tags to their offsets.
+    func tableDirectory() throws -> [String: Int] {
+        let tableCount = Int(try u16(4))
+        var tables: [String: Int] = [:]
+        for index in 0..<tableCount {
+            let record = 12 + 16 * index
+            guard record + 16 <= bytes.count else { throw outOfBounds(record) }
+            let tag = String(decoding: bytes[record..<(record + 4)], as: UTF8.self)
+            tables[tag] = Int(try u32(record + 8))
+        }
+        return tables
+    }
+
+    /// Reads the best Unicode subtable of the `cmap` table: format 12 if there is one,
+    /// otherwise format 4.
+    func characterMap(at cmap: Int, glyphCount: Int) throws -> [UInt32: UInt16] {
+        var format4: Int?
+        var format12: Int?
+        for index in 0..<Int(try u16(cmap + 2)) {
+            let record = cmap + 4 + 8 * index
+            let platform = try u16(record)
+            let encoding = try u16(record + 2)
+            let subtable = cmap + Int(try u32(record + 4))
+            // Unicode, or Windows Unicode BMP / full repertoire.
+            guard platform == 0 || (platform == 3 && (encoding == 1 || encoding == 10)) else { continue }
+            switch try u16(subtable) {
+            case 4 where format4 == nil: format4 = subtable
+            case 12 where format12 == nil: format12 = subtable
+            default: break
+            }
+        }
+
+        var glyphs: [UInt32: UInt16] = [:]
+        func insert(_ codePoint: UInt32, _ glyph: Int) {
+            if glyph != 0 && glyph < glyphCount { glyphs[codePoint] = UInt16(glyph) }
+        }
+        if let subtable = format12 {
+            for group in 0..<Int(try u32(subtable + 12)) {
+                let record = subtable + 16 + 12 * group
+                let start = try u32(record)
+                let end = try u32(record + 4)
+                let startGlyph = Int(try u32(record + 8))
+                guard start <= end, end <= 0x10FFFF else { continue }
+                for codePoint in start...end {
+                    insert(codePoint, startGlyph + Int(codePoint - start))
+                }
+            }
+        } else if let subtable = format4 {
+            let segmentCount = Int(try u16(subtable + 6)) / 2
+            let endCodes = subtable + 14
+            let startCodes = endCodes + 2 * segmentCount + 2
+            let deltas = startCodes + 2 * segmentCount
+            let rangeOffsets = deltas + 2 * segmentCount
+            for segment in 0..<segmentCount {
+                let start = Int(try u16(startCodes + 2 * segment))
+                let end = Int(try u16(endCodes + 2 * segment))
+                let delta = Int(try u16(deltas + 2 * segment))
+                let rangeOffset = Int(try u16(rangeOffsets + 2 * segment))
+                guard start <= end, start != 0xFFFF else { continue }
+                for codePoint in start...end {
+                    var glyph: Int
+                    if rangeOffset == 0 {
+                        glyph = (codePoint + delta) & 0xFFFF
+                    } else {
+                        // The offset is relative to the range offset's own location.
+                        let address = rangeOffsets + 2 * segment + rangeOffset + 2 * (codePoint - start)
+                        glyph = Int(try u16(address))
+                        if glyph != 0 { glyph = (glyph + delta) & 0xFFFF }
+                    }
+                    insert(UInt32(codePoint), glyph)
+                }
+            }
+        }
+        return glyphs
+    }
+
+    /// Reads the horizontal format 0 subtables of the `kern` table, keyed by
+    /// `left << 16 | right`.
+    func kerningPairs(at kern: Int) throws -> [UInt32: Int16] {
+        var pairs: [UInt32: Int16] = [:]
+        var subtable = kern + 4
+        for _ in 0..<Int(try u16(kern + 2)) {
+            let length = Int(try u16(subtable + 2))
+            let coverage = try u16(subtable + 4)
+            // Format 0 (high byte), horizontal (bit 0), not minimum values or cross-stream.
+            if coverage >> 8 == 0 && coverage & 0x7 == 0x1 {
+                let pairCount = Int(try u16(subtable + 6))
+                for index in 0..<pairCount {
+                    let record = subtable + 14 + 6 * index
+                    let key = UInt32(try u16(record)) << 16 | UInt32(try u16(record + 2))
+                    pairs[key] = try i16(record + 4)
+                }
+            }
+            guard length > 0 else { break }
+            subtable += length
+        }
+        return pairs
+    }
+}
@@ -112,19 +112,16 @@ extension BarGraph: HasGraphLayout {
         guard series.count > 0 else { return (results, markers) }
         if (graphOrientation == .vertical) {
             results.barWidth = Int(round(size.width/Float(series.count)))
-            maximumY = maxY(points: series.values)
-            minimumY = minY(points: series.values)
+            (minimumY, maximumY) = boundsY(points: series.values)
         }
         else{
             results.barWidth = Int(round(size.height/Float(series.count)))
-            maximumX = maxY(points: series.values)
-            minimumX = minY(points: series.values)
+            (minimumX, maximumX) = boundsY(points: series.values)
         }
 
         if (graphOrientation == .vertical) {
             for s in stackSeries {
-                let minStackY = minY(points: s.values)
-                let maxStackY = maxY(points: s.values)
+                let (minStackY, maxStackY) = boundsY(points: s.values)
 
                 if (maxStackY > U(0)) {
                     maximumY = maximumY + maxStackY
@@ -209,18 +206,16 @@ extension BarGraph: HasGraphLayout {
         }
 
         else{
-            var x = maxY(points: series.values)
-            if (x > maximumX) {
-                maximumX = x
+            let (seriesMinX, seriesMaxX) = boundsY(points: series.values)
+            if (seriesMaxX > maximumX) {
+                maximumX = seriesMaxX
             }
-            x = minY(points: series.values)
-            if (x < minimumX) {
-                minimumX = x
+            if (seriesMinX < minimumX) {
+                minimumX = seriesMinX
             }
 
             for s in stackSeries {
-                let minStackX = minY(points: s.values)
-                let maxStackX = maxY(points: s.values)
+                let (minStackX, maxStackX) = boundsY(points: s.values)
                 maximumX = maximumX + maxStackX
                 minimumX = minimumX - minStackX
             }
@@ -298,6 +293,17 @@ extension BarGraph: HasGraphLayout {
 
     //functions to draw the plot
     public func drawData(_ data: DrawingData, size: Size, renderer: Renderer) {
+        // The bars are collected and drawn together, so that stacked segments can be
+        // filled in one pass.
+        var rects = [Rect]()
+        var fillColors = [Color]()
+        var hatchPatterns = [BarGraphSeriesOptions.Hatching]()
+        func addBar(_ rect: Rect, _ series: Series<T,U>) {
+            rects.append(rect)
+            fillColors.append(series.color)
+            hatchPatterns.append(series.barGraphSeriesOptions.hatchPattern)
+        }
+
         if (graphOrientation == .vertical) {
             for index in 0..<data.series_scaledValues.count {
                 var currentHeightPositive: Float = 0
@@ -314,9 +320,7 @@ extension BarGraph: HasGraphLayout {
                 else {
                     currentHeightNegative = rect.size.height
                 }
-                renderer.drawSolidRect(rect,
-                                       fillColor: series.color,
-                                       hatchPattern: series.barGraphSeriesOptions.hatchPattern)
+                addBar(rect, series)
                 for i in 0..<data.stackSeries_scaledValues.count {
                     let stackValue = Float(data.stackSeries_scaledValues[i][index].y)
                     if (stackValue - data.origin.y >= 0) {
@@ -329,9 +333,7 @@ extension BarGraph: HasGraphLayout {
                         rect.size.height = stackValue - data.origin.y
                         currentHeightNegative += stackValue
                     }
-                    renderer.drawSolidRect(rect,
-                                           fillColor: stackSeries[i].color,
-                                           hatchPattern: stackSeries[i].barGraphSeriesOptions.hatchPattern)
+                    addBar(rect, stackSeries[i])
                 }
             }
         }
@@ -351,9 +353,7 @@ extension BarGraph: HasGraphLayout {
                 else {
                     currentWidthNegative = rect.size.width
                 }
-                renderer.drawSolidRect(rect,
-                                       fillColor: series.color,
-                                       hatchPattern: series.barGraphSeriesOptions.hatchPattern)
+                addBar(rect, series)
                 for i in 0..<stackSeries.count {
                     let stackValue = Float(data.stackSeries_scaledValues[i][index].x)
                     if (stackValue - data.origin.x >= 0) {
@@ -366,11 +366,20 @@ extension BarGraph: HasGraphLayout {
                         rect.size.width = stackValue - data.origin.x
                         currentWidthNegative += stackValue
                     }
-                    renderer.drawSolidRect(rect,
-                                           fillColor: stackSeries[i].color,
-                                           hatchPattern: stackSeries[i].barGraphSeriesOptions.hatchPattern)
+                    addBar(rect, stackSeries[i])
                 }
             }
         }
+
+        if hatchPatterns.allSatisfy({ $0 == .none }) {
+            renderer.drawSolidRects(rects, fillColors: fillColors)
+        }
+        else {
+            for index in rects.indices {
+                renderer.drawSolidRect(rects[index],
+                                       fillColor: fillColors[index],
+                                       hatchPattern: hatchPatterns[index])
+            }
+        }
     }
 }
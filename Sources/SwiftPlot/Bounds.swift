@@ -0,0 +1,122 @@
+import Foundation
+
+// Work over at least twice this many elements is split into chunks which are processed concurrently.
+fileprivate let MIN_CONCURRENT_CHUNK = 1 << 17
+
+/// Returns the smallest and largest x and y values of `points`, which must not be empty.
+///
+/// All four extremes are found in a single pass, rather than the four of `minX`, `maxX`,
+/// `minY` and `maxY`. `Float` and `Double` points are compared several at a time with
+/// SIMD vectors, and long arrays are split into chunks which are scanned concurrently.
+public func boundsXY<T,U>(points: [Pair<T,U>]) -> (minX: T, maxX: T, minY: U, maxY: U) where T: Comparable, U: Comparable {
+    return reduceConcurrently(count: points.count, { range in
+        points.withUnsafeBufferPointer { buffer in
+            if T.self == Float.self && U.self == Float.self {
+                let r = buffer.withInterleavedScalars(of: Float.self) { simdBounds($0, range) }
+                return (r.minX as! T, r.maxX as! T, r.minY as! U, r.maxY as! U)
+            }
+            if T.self == Double.self && U.self == Double.self {
+                let r = buffer.withInterleavedScalars(of: Double.self) { simdBounds($0, range) }
+                return (r.minX as! T, r.maxX as! T, r.minY as! U, r.maxY as! U)
+            }
+            return scalarBounds(buffer, range)
+        }
+    }, combine: { a, b in
+        (min(a.minX, b.minX), max(a.maxX, b.maxX), min(a.minY, b.minY), max(a.maxY, b.maxY))
+    })
+}
+
+/// Returns the smallest and largest y values of `points`, which must not be empty, in a
+/// single pass. This is for charts whose x values are only labels.
+public func boundsY<T,U>(points: [Pair<T,U>]) -> (minY: U, maxY: U) where U: Comparable {
+    return reduceConcurrently(count: points.count, { range in
+        points.withUnsafeBufferPointer { buffer in
+            var minY = buffer[range.lowerBound].y
+            var maxY = minY
+            for index in range.dropFirst() {
+                let y = buffer[index].y
+                if (y < minY) { minY = y }
+                if (y > maxY) { maxY = y }
+            }
+            return (minY, maxY)
+        }
+    }, combine: { a, b in
+        (min(a.minY, b.minY), max(a.maxY, b.maxY))
+    })
+}
+
+/// Calls `body` with consecutive chunks of `0..<count`, concurrently if there are enough
+/// elements to be worth it, and combines the results in order.
+func reduceConcurrently<R>(count: Int, _ body: (Range<Int>) -> R,
+                          combine: (R, R) -> R) -> R {
+    precondition(count > 0, "reduceConcurrently: expected at least 1 element.")
+    let chunks = min(ProcessInfo.processInfo.activeProcessorCount, count / MIN_CONCURRENT_CHUNK)
+    guard chunks > 1 else { return body(0..<count) }
+
+    let chunkSize = (count + chunks - 1) / chunks
+    var results = [R?](repeating: nil, count: chunks)
+    results.withUnsafeMutableBufferPointer { results in
+        DispatchQueue.concurrentPerform(iterations: chunks) { chunk in
+            let start = chunk * chunkSize
+            results[chunk] = body(start..<min(start + chunkSize, count))
+        }
+    }
+    return results.dropFirst().reduce(results[0]!) { combine($0, $1!) }
+}
+
+fileprivate func scalarBounds<T,U>(_ points: UnsafeBufferPointer<Pair<T,U>>,
+                                   _ range: Range<Int>) -> (minX: T, maxX: T, minY: U, maxY: U)
+    where T: Comparable, U: Comparable {
+    let first = points[range.lowerBound]
+    var (minX, maxX, minY, maxY) = (first.x, first.x, first.y, first.y)
+    for index in range.dropFirst() {
+        let point = points[index]
+        if (point.x < minX) { minX = point.x }
+        if (point.x > maxX) { maxX = point.x }
+        if (point.y < minY) { minY = point.y }
+        if (point.y > maxY) { maxY = point.y }
+    }
+    return (minX, maxX, minY, maxY)
+}
+
+/// The bounds of the points in `range`, stored as interleaved x and y values at `values`.
+/// Four points are compared at a time, with x in the even lanes and y in the odd lanes.
+/// Like `scalarBounds`, a NaN is only kept if it is the first value of its column.
+fileprivate func simdBounds<S>(_ values: UnsafePointer<S>,
+                               _ range: Range<Int>) -> (minX: S, maxX: S, minY: S, maxY: S)
+    where S: SIMDScalar & FloatingPoint {
+    let first = range.lowerBound
+    var low = SIMD8<S>(values[2 * first], values[2 * first + 1],
+                       values[2 * first], values[2 * first + 1],
+                       values[2 * first], values[2 * first + 1],
+                       values[2 * first], values[2 * first + 1])
+    var high = low
+    var index = first
+    while index + 4 <= range.upperBound {
+        var vector = SIMD8<S>()
+        withUnsafeMutableBytes(of: &vector) {
+            $0.copyMemory(from: UnsafeRawBufferPointer(start: values + 2 * index,
+                                                       count: 8 * MemoryLayout<S>.stride))
+        }
+        low.replace(with: vector, where: vector .< low)
+        high.replace(with: vector, where: vector .> high)
+        index += 4
+    }
+    var (minX, maxX) = (low[0], high[0])
+    var (minY, maxY) = (low[1], high[1])
+    for lane in stride(from: 2, to: 8, by: 2) {
+        if (low[lane] < minX) { minX = low[lane] }
+        if (high[lane] > maxX) { maxX = high[lane] }
+        if (low[lane + 1] < minY) { minY = low[lane + 1] }
+        if (high[lane + 1] > maxY) { maxY = high[lane + 1] }
+    }
+    while index < range.upperBound {
+        let (x, y) = (values[2 * index], values[2 * index + 1])
+        if (x < minX) { minX = x }
+        if (x > maxX) { maxX = x }
+        if (y < minY) { minY = y }
+        if (y > maxY) { maxY = y }
+        index += 1
+    }
+    return (minX, maxX, minY, maxY)
+}
@@ -1,4 +1,4 @@
-public struct Color {
+public struct Color: Hashable {
     public var r: Float
     public var g: Float
     public var b: Float
@@ -0,0 +1,107 @@
+import Foundation
+
+/// Maps data values to positions on a chart, as `(value - originValue) / scale + origin`
+/// along each axis.
+///
+/// Besides single values, whole series can be transformed at once into separate x and y
+/// columns of `Float`s, which is the form renderers hand to their drawing backends.
+/// `Float` and `Double` series are transformed several values at a time with SIMD vectors.
+public struct CoordinateTransform<T: FloatConvertible, U: FloatConvertible> {
+    public var originValue: Pair<T,U>
+    public var origin: Point
+    public var scaleX: Float
+    public var scaleY: Float
+
+    public init(originValue: Pair<T,U>, origin: Point, scaleX: Float, scaleY: Float) {
+        self.originValue = originValue
+        self.origin = origin
+        self.scaleX = scaleX
+        self.scaleY = scaleY
+    }
+
+    /// Returns the position of `value`.
+    public func apply(_ value: Pair<T,U>) -> Point {
+        return Point(Float(((value.x - originValue.x) / T(scaleX)) + T(origin.x)),
+                     Float(((value.y - originValue.y) / U(scaleY)) + U(origin.y)))
+    }
+
+    /// Writes the positions of `values`, moved by `offset`, to `xs` and `ys`, which must
+    /// each have room for `values.count` elements.
+    public func apply(_ values: [Pair<T,U>], offset: Point = .zero,
+                      xs: UnsafeMutablePointer<Float>, ys: UnsafeMutablePointer<Float>) {
+        values.withUnsafeBufferPointer { apply($0, offset: offset, xs: xs, ys: ys) }
+    }
+
+    func apply(_ values: UnsafeBufferPointer<Pair<T,U>>, offset: Point = .zero,
+               xs: UnsafeMutablePointer<Float>, ys: UnsafeMutablePointer<Float>) {
+        guard !values.isEmpty else { return }
+        if T.self == Float.self && U.self == Float.self {
+            values.withInterleavedScalars(of: Float.self) {
+                transformColumns($0, count: values.count,
+                                 originValue: (originValue.x as! Float, originValue.y as! Float),
+                                 scale: (scaleX, scaleY), origin: (origin.x, origin.y),
+                                 offset: offset, xs: xs, ys: ys)
+            }
+        } else if T.self == Double.self && U.self == Double.self {
+            values.withInterleavedScalars(of: Double.self) {
+                transformColumns($0, count: values.count,
+                                 originValue: (originValue.x as! Double, originValue.y as! Double),
+                                 scale: (Double(scaleX), Double(scaleY)), origin: (Double(origin.x), Double(origin.y)),
+                                 offset: offset, xs: xs, ys: ys)
+            }
+        } else {
+            for (index, value) in values.enumerated() {
+                let position = apply(value)
+                xs[index] = position.x + offset.x
+                ys[index] = position.y + offset.y
+            }
+        }
+    }
+
+    /// Returns the positions of `values`, moved by `offset`, as x and y columns.
+    public func apply(_ values: [Pair<T,U>], offset: Point = .zero) -> (xs: [Float], ys: [Float]) {
+        var ys = [Float]()
+        let xs = [Float](unsafeUninitializedCapacity: values.count) { xBuffer, xCount in
+            ys = [Float](unsafeUninitializedCapacity: values.count) { yBuffer, yCount in
+                if values.count > 0 {
+                    apply(values, offset: offset, xs: xBuffer.baseAddress!, ys: yBuffer.baseAddress!)
+                }
+                yCount = values.count
+            }
+            xCount = values.count
+        }
+        return (xs, ys)
+    }
+}
+
+/// Transforms `count` points stored as interleaved x and y values at `values`, four at a
+/// time with x in the even lanes and y in the odd lanes. Every operation is the same as in
+/// `CoordinateTransform.apply(_:)`, so the results are identical.
+fileprivate func transformColumns<S>(_ values: UnsafePointer<S>, count: Int,
+                                     originValue: (S, S), scale: (S, S), origin: (S, S), offset: Point,
+                                     xs: UnsafeMutablePointer<Float>, ys: UnsafeMutablePointer<Float>)
+    where S: SIMDScalar & BinaryFloatingPoint {
+    let originValues = SIMD8<S>(originValue.0, originValue.1, originValue.0, originValue.1,
+                                originValue.0, originValue.1, originValue.0, originValue.1)
+    let scales = SIMD8<S>(scale.0, scale.1, scale.0, scale.1, scale.0, scale.1, scale.0, scale.1)
+    let origins = SIMD8<S>(origin.0, origin.1, origin.0, origin.1, origin.0, origin.1, origin.0, origin.1)
+    var index = 0
+    while index + 4 <= count {
+        var vector = SIMD8<S>()
+        withUnsafeMutableBytes(of: &vector) {
+            $0.copyMemory(from: UnsafeRawBufferPointer(start: values + 2 * index,
+                                                       count: 8 * MemoryLayout<S>.stride))
+        }
+        let positions = (vector - originValues) / scales + origins
+        for lane in 0..<4 {
+            xs[index + lane] = Float(positions[2 * lane]) + offset.x
+            ys[index + lane] = Float(positions[2 * lane + 1]) + offset.y
+        }
+        index += 4
+    }
+    while index < count {
+        xs[index] = Float((values[2 * index] - originValue.0) / scale.0 + origin.0) + offset.x
+        ys[index] = Float((values[2 * index + 1] - originValue.1) / scale.1 + origin.1) + offset.y
+        index += 1
+    }
+}
@@ -0,0 +1,164 @@
+import Foundation
+
+/// Options for drawing a plot's points as a density image, rather than as a marker each.
+///
+/// The points are counted in a grid with a cell for each pixel of the plot, and the
+/// counts are shaded with `colorMap` and drawn as a single image. Drawing then depends
+/// on the number of points only through the counting loop, and dense regions stay
+/// distinguishable instead of saturating under overlapping markers.
+public struct DensityRendering {
+
+    /// How the count of each cell is mapped to an offset in the color map. Empty cells
+    /// are always left transparent.
+    public enum Normalization {
+        /// Offsets proportional to the count.
+        case linear
+        /// Offsets proportional to the logarithm of the count, so that sparse regions
+        /// remain visible next to dense ones.
+        case logarithmic
+        /// Offsets given by the fraction of non-empty cells with a lower count, which
+        /// spreads the counts evenly over the color map.
+        case histogramEqualization
+    }
+
+    public var colorMap: ColorMap
+    public var normalization: Normalization
+
+    public init(colorMap: ColorMap = .viridis, normalization: Normalization = .histogramEqualization) {
+        self.colorMap = colorMap
+        self.normalization = normalization
+    }
+}
+
+/// The number of points in each unit cell of a grid covering `size`, with the cells in
+/// rows from the bottom up.
+struct DensityGrid {
+    let size: Size
+    let width: Int
+    let height: Int
+    var counts: [UInt32]
+
+    init(size: Size) {
+        self.size = size
+        width = max(Int(size.width.rounded(.up)), 1)
+        height = max(Int(size.height.rounded(.up)), 1)
+        counts = [UInt32](repeating: 0, count: width * height)
+    }
+
+    /// Counts the points of `values` which lie within `size` once placed at
+    /// `value * scaleInv + origin`, as `ScatterPlot` places its markers. Long series are
+    /// counted in chunks concurrently, each into its own grid.
+    mutating func add<T: FloatConvertible, U: FloatConvertible>(_ values: [Pair<T,U>],
+                                                                scaleXInv: Float, scaleYInv: Float,
+                                                                origin: Point) {
+        guard !values.isEmpty else { return }
+        let (width, height, size) = (self.width, self.height, self.size)
+        func countPoint(_ x: Float, _ y: Float, into cells: UnsafeMutableBufferPointer<UInt32>) {
+            guard x >= 0 && x <= size.width && y >= 0 && y <= size.height else { return }
+            let column = min(Int(x), width - 1)
+            let row = min(Int(y), height - 1)
+            cells[row * width + column] &+= 1
+        }
+        let counted = reduceConcurrently(count: values.count, { range -> [UInt32] in
+            var counts = [UInt32](repeating: 0, count: width * height)
+            counts.withUnsafeMutableBufferPointer { cells in
+                values.withUnsafeBufferPointer { buffer in
+                    // Float and Double points are read directly, without generic arithmetic.
+                    if T.self == Float.self && U.self == Float.self {
+                        buffer.withInterleavedScalars(of: Float.self) { v -> Void in
+                            for index in range {
+                                countPoint(v[2 * index] * scaleXInv + origin.x,
+                                           v[2 * index + 1] * scaleYInv + origin.y, into: cells)
+                            }
+                        }
+                    } else if T.self == Double.self && U.self == Double.self {
+                        let (scaleX, scaleY) = (Double(scaleXInv), Double(scaleYInv))
+                        let (originX, originY) = (Double(origin.x), Double(origin.y))
+                        buffer.withInterleavedScalars(of: Double.self) { v -> Void in
+                            for index in range {
+                                countPoint(Float(v[2 * index] * scaleX + originX),
+                                           Float(v[2 * index + 1] * scaleY + originY), into: cells)
+                            }
+                        }
+                    } else {
+                        for index in range {
+                            let value = buffer[index]
+                            countPoint(Float(value.x * T(scaleXInv) + T(origin.x)),
+                                       Float(value.y * U(scaleYInv) + U(origin.y)), into: cells)
+                        }
+                    }
+                }
+            }
+            return counts
+        }, combine: { a, b in
+            var sum = a
+            for index in sum.indices { sum[index] &+= b[index] }
+            return sum
+        })
+        for index in counts.indices { counts[index] &+= counted[index] }
+    }
+
+    /// The offset in the color map of each cell, or `nil` for empty cells.
+    func offsets(_ normalization: DensityRendering.Normalization) -> [Double?] {
+        return normalization.offsets(for: counts)
+    }
+
+    /// The cells shaded with `rendering`, as RGBA bytes for `Renderer.drawImage`.
+    func image(_ rendering: DensityRendering) -> [UInt8] {
+        let shades = DensityRendering.Normalization.shades(of: rendering.colorMap)
+        var pixels = [UInt8](repeating: 0, count: width * height * 4)
+        for (index, offset) in offsets(rendering.normalization).enumerated() {
+            guard let offset = offset else { continue }
+            let shade = shades[DensityRendering.Normalization.shadeIndex(offset)]
+            (pixels[4 * index], pixels[4 * index + 1], pixels[4 * index + 2], pixels[4 * index + 3]) = shade
+        }
+        return pixels
+    }
+}
+
+extension DensityRendering.Normalization {
+
+    /// The offset in the color map for each of `counts`, or `nil` for counts of zero.
+    func offsets(for counts: [UInt32]) -> [Double?] {
+        let maxCount = Double(counts.max() ?? 0)
+        switch self {
+        case .linear:
+            return counts.map { $0 == 0 ? nil : Double($0) / maxCount }
+        case .logarithmic:
+            let logMax = log1p(maxCount)
+            return counts.map { $0 == 0 ? nil : (logMax > 0 ? log1p(Double($0)) / logMax : 1) }
+        case .histogramEqualization:
+            // The fraction of non-zero counts which are no greater than each count, rescaled
+            // so that the lowest count maps to 0.
+            var occurrences = [UInt32: Int]()
+            for count in counts where count > 0 { occurrences[count, default: 0] += 1 }
+            let total = occurrences.values.reduce(0, +)
+            var cumulative = [UInt32: Double]()
+            var soFar = 0
+            var lowest = 0
+            for (count, times) in occurrences.sorted(by: { $0.key < $1.key }) {
+                soFar += times
+                if lowest == 0 { lowest = soFar }
+                cumulative[count] = total > lowest ? Double(soFar - lowest) / Double(total - lowest) : 1
+            }
+            return counts.map { $0 == 0 ? nil : cumulative[$0] }
+        }
+    }
+
+    /// A table of 256 colors spread evenly over `colorMap`, as RGBA bytes, for shading
+    /// many offsets without asking the color map for each.
+    static func shades(of colorMap: ColorMap) -> [(UInt8, UInt8, UInt8, UInt8)] {
+        return (0...255).map { index -> (UInt8, UInt8, UInt8, UInt8) in
+            let color = colorMap.colorForOffset(Double(index) / 255)
+            func byte(_ component: Float) -> UInt8 {
+                return UInt8(clamp(component, minValue: 0, maxValue: 1) * 255 + 0.5)
+            }
+            return (byte(color.r), byte(color.g), byte(color.b), byte(color.a))
+        }
+    }
+
+    /// The index in `shades(of:)` of the color for `offset`.
+    static func shadeIndex(_ offset: Double) -> Int {
+        return Int(clamp(offset, minValue: 0, maxValue: 1) * 255 + 0.5)
+    }
+}
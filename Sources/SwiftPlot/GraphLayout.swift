@@ -1,6 +1,6 @@
 import Foundation
 
-public enum LegendIcon {
+public enum LegendIcon: Hashable {
     case square(Color)
     case shape(ScatterPlotSeriesOptions.ScatterPattern, Color)
 }
@@ -26,6 +26,10 @@ public struct GraphLayout {
     var enablePrimaryAxisGrid = true
     var enableSecondaryAxisGrid = true
     var drawsGridOverForeground = false
+    var clipsDataToPlotRect = false
+    // Whether the plot shows only a range of its data, which is then clipped to the plot
+    // area whatever `clipsDataToPlotRect` is set to.
+    var hasVisibleRanges = false
     var markerTextSize: Float = 12
     var markerThickness: Float = 2
     /// The amount of (horizontal) space to reserve for markers on the Y-axis.
@@ -50,7 +54,7 @@ public struct GraphLayout {
         /// The measured sizes of the plot elements.
         let sizes: EdgeComponents<[Size]>
         
-        let plotMarkers: PlotMarkers
+        var plotMarkers: PlotMarkers
         let legendLabels: [(String, LegendIcon)]
         
         var xMarkersTextLocation = [Point]()
@@ -220,7 +224,7 @@ extension GraphLayout {
         let xLabelOffset = plotBorder.thickness + Self.markerStemLength + Self.xMarkerSpace
         let yLabelOffset = plotBorder.thickness + Self.markerStemLength + Self.yMarkerSpace
         for i in 0..<plan.plotMarkers.xMarkers.count {
-            let textSize = renderer.getTextLayoutSize(text: plan.plotMarkers.xMarkersText[i], textSize: markerTextSize)
+            let textSize = renderer.getCachedTextLayoutSize(text: plan.plotMarkers.xMarkersText[i], textSize: markerTextSize)
             let markerLocation = plan.plotMarkers.xMarkers[i]
             var textLocation   = Point(0, -xLabelOffset - textSize.height)
             switch markerLabelAlignment {
@@ -258,8 +262,8 @@ extension GraphLayout {
         }
       
         for i in 0..<plan.plotMarkers.yMarkers.count {
-            var textSize = renderer.getTextLayoutSize(text: plan.plotMarkers.yMarkersText[i],
-                                                      textSize: markerTextSize)
+            var textSize = renderer.getCachedTextLayoutSize(text: plan.plotMarkers.yMarkersText[i],
+                                                            textSize: markerTextSize)
             textSize.width = min(textSize.width, yMarkerMaxWidth)
             var textLocation = Point(-yLabelOffset - textSize.width, 0)
             textLocation.y = alignYLabel(markers: plan.plotMarkers.yMarkers, index: i, textSize: textSize)
@@ -267,8 +271,8 @@ extension GraphLayout {
         }
         
         for i in 0..<plan.plotMarkers.y2Markers.count {
-            var textSize = renderer.getTextLayoutSize(text: plan.plotMarkers.y2MarkersText[i],
-                                                      textSize: markerTextSize)
+            var textSize = renderer.getCachedTextLayoutSize(text: plan.plotMarkers.y2MarkersText[i],
+                                                            textSize: markerTextSize)
             textSize.width = min(textSize.width, yMarkerMaxWidth)
             var textLocation = Point(yLabelOffset + plan.plotBorderRect.width, 0)
             textLocation.y = alignYLabel(markers: plan.plotMarkers.y2Markers, index: i, textSize: textSize)
@@ -298,7 +302,16 @@ extension GraphLayout {
 
 extension GraphLayout {
     
-    fileprivate func drawBackground(_ plan: LayoutPlan, renderer: Renderer) {
+    /// Draws everything beneath the data. If a `layerKey` is given, it is drawn as a layer,
+    /// which the renderer may have cached.
+    fileprivate func drawBackground(_ plan: LayoutPlan, layerKey: Int? = nil, renderer: Renderer) {
+        if let layerKey = layerKey {
+            renderer.drawLayer(layerKey, in: Rect(origin: .zero, size: plan.totalSize),
+                               isOpaque: backgroundColor.a >= 1) { renderer in
+                self.drawBackground(plan, renderer: renderer)
+            }
+            return
+        }
         renderer.drawSolidRect(Rect(origin: .zero, size: plan.totalSize),
                                fillColor: backgroundColor, hatchPattern: .none)
         if let plotBackgroundColor = plotBackgroundColor {
@@ -311,14 +324,27 @@ extension GraphLayout {
         drawMarkers(plan, renderer: renderer)
     }
     
-    fileprivate func drawForeground(_ plan: LayoutPlan, renderer: Renderer) {
+    /// Draws everything over the data. If a `layerKey` is given, all but the annotations is
+    /// drawn as a layer, which the renderer may have cached.
+    fileprivate func drawForeground(_ plan: LayoutPlan, layerKey: Int? = nil, renderer: Renderer) {
+        if let layerKey = layerKey {
+            renderer.drawLayer(layerKey, in: Rect(origin: .zero, size: plan.totalSize),
+                               isOpaque: false) { renderer in
+                self.drawForegroundLayer(plan, renderer: renderer)
+            }
+        } else {
+            drawForegroundLayer(plan, renderer: renderer)
+        }
+        drawAnnotations(resolver: plan, renderer: renderer)
+    }
+    
+    private func drawForegroundLayer(_ plan: LayoutPlan, renderer: Renderer) {
         if drawsGridOverForeground {
           drawGrid(plan, renderer: renderer)
         }
         drawLayoutComponents(plan.allComponents, plotRect: plan.plotBorderRect,
                              measuredSizes: plan.sizes, renderer: renderer)
         drawLegend(plan.legendLabels, plan: plan, renderer: renderer)
-        drawAnnotations(resolver: plan, renderer: renderer)
     }
     
     private func drawLayoutComponents(_ components: EdgeComponents<[LayoutComponent]>, plotRect: Rect,
@@ -521,6 +547,106 @@ extension GraphLayout {
     }
 }
 
+// Incremental updates.
+
+extension GraphLayout {
+    
+    /// Redraws the part `rect` of the plot area of a graph drawn with `plan`, given in the
+    /// plot's coordinates and widened to whole pixels: the background and grid, the data
+    /// drawn by `drawData`, and the legend and annotations over them. Nothing outside it is
+    /// drawn, so the renderer must support incremental updates.
+    func redrawPlotArea(_ rect: Rect, plan: LayoutPlan, renderer: Renderer, drawData: (Renderer) -> Void) {
+        let plotRect = plan.plotBorderRect.roundedInwards
+        let area = rect.normalized
+        let origin = plan.plotBorderRect.origin
+        let minX = max((area.minX + origin.x).rounded(.down), plotRect.minX)
+        let maxX = min((area.maxX + origin.x).rounded(.up), plotRect.maxX)
+        let minY = max((area.minY + origin.y).rounded(.down), plotRect.minY)
+        let maxY = min((area.maxY + origin.y).rounded(.up), plotRect.maxY)
+        guard minX < maxX, minY < maxY else { return }
+        let dirtyRect = Rect(origin: Point(minX, minY), size: Size(width: maxX - minX, height: maxY - minY))
+        
+        renderer.setClipRect(dirtyRect)
+        renderer.drawSolidRect(dirtyRect, fillColor: plotBackgroundColor ?? backgroundColor, hatchPattern: .none)
+        if !drawsGridOverForeground {
+          drawGrid(plan, renderer: renderer)
+        }
+        renderer.withAdditionalOffset(plan.plotBorderRect.origin) { renderer in
+            drawData(renderer)
+        }
+        if drawsGridOverForeground {
+          drawGrid(plan, renderer: renderer)
+        }
+        drawLegend(plan.legendLabels, plan: plan, renderer: renderer)
+        drawAnnotations(resolver: plan, renderer: renderer)
+        renderer.setClipRect(nil)
+    }
+    
+    /// Replaces the x-axis markers of a graph drawn with `plan`, and redraws the band below
+    /// the plot which holds them. The renderer must support incremental updates.
+    func redrawXMarkers(_ markers: [Float], text: [String], plan: inout LayoutPlan, renderer: Renderer) {
+        plan.plotMarkers.xMarkers = markers
+        plan.plotMarkers.xMarkersText = text
+        plan.xMarkersTextLocation = []
+        plan.yMarkersTextLocation = []
+        plan.y2MarkersTextLocation = []
+        calcMarkerTextLocations(renderer: renderer, plan: &plan)
+        
+        // The band is the space layoutPlotRect leaves for the markers, and the bottom edge of
+        // the border, which is drawn again over the background.
+        let xMarkerHeight = Self.markerStemLength + (2 * Self.xMarkerSpace) + markerTextSize
+        let bandHeight = xMarkerHeight + plotBorder.thickness
+        var band = Rect(origin: Point(0, plan.plotBorderRect.minY - bandHeight),
+                        size: Size(width: plan.totalSize.width, height: bandHeight))
+        band.origin.y.round(.down)
+        band.size.height = plan.plotBorderRect.minY - band.minY
+        renderer.setClipRect(band)
+        renderer.drawSolidRect(band, fillColor: backgroundColor, hatchPattern: .none)
+        drawBorder(plan, renderer: renderer)
+        drawMarkers(plan, renderer: renderer)
+        renderer.setClipRect(nil)
+    }
+}
+
+// Layer caching.
+
+extension GraphLayout {
+    
+    /// Keys for the layers drawn beneath and over the data for `plan`, which identify
+    /// everything drawn in them, so that renderers can cache the layers between graphs whose
+    /// axes and labels are the same.
+    func layerKeys(_ plan: LayoutPlan, renderer: Renderer) -> (background: Int, foreground: Int) {
+        var hasher = Hasher()
+        hasher.combine(backgroundColor)
+        hasher.combine(plotBackgroundColor)
+        hasher.combine(plotTitle)
+        hasher.combine(plotLabel)
+        hasher.combine(plotLegend)
+        hasher.combine(plotBorder)
+        hasher.combine(grid)
+        hasher.combine(enablePrimaryAxisGrid)
+        hasher.combine(enableSecondaryAxisGrid)
+        hasher.combine(drawsGridOverForeground)
+        hasher.combine(markerTextSize)
+        hasher.combine(markerThickness)
+        hasher.combine(yMarkerMaxWidth)
+        hasher.combine(markerLabelAlignment)
+        hasher.combine(plan.totalSize)
+        hasher.combine(plan.plotBorderRect)
+        hasher.combine(plan.plotMarkers)
+        for (label, icon) in plan.legendLabels {
+            hasher.combine(label)
+            hasher.combine(icon)
+        }
+        // Text is measured and drawn with the renderer's font.
+        hasher.combine(renderer.fontIdentifier)
+        var foregroundHasher = hasher
+        hasher.combine(0)
+        foregroundHasher.combine(1)
+        return (hasher.finalize(), foregroundHasher.finalize())
+    }
+}
+
 // Debugging.
 
 extension GraphLayout {
@@ -624,21 +750,47 @@ extension HasGraphLayout {
       get { layout.markerThickness }
       set { layout.markerThickness = newValue }
     }
+
+    /// Whether data outside the plot area is clipped away, so that data far outside
+    /// the axes' bounds costs little to draw. Defaults to `false`.
+    public var clipsDataToPlotRect: Bool {
+        get { layout.clipsDataToPlotRect }
+        set { layout.clipsDataToPlotRect = newValue }
+    }
 }
 
 extension Plot where Self: HasGraphLayout {
     
     public func drawGraph(size: Size, renderer: Renderer) {
+        drawGraphKeepingLayout(size: size, renderer: renderer)
+    }
+    
+    /// Draws the graph, and returns its drawing data and layout so that parts of it can be
+    /// redrawn later.
+    @discardableResult
+    func drawGraphKeepingLayout(size: Size, renderer: Renderer) -> (DrawingData, GraphLayout.LayoutPlan) {
         let (drawingData, plan) = layout.layout(size: size, renderer: renderer) {
             size -> (DrawingData, PlotMarkers?, [(String, LegendIcon)]?) in
             let tup = layoutData(size: size, renderer: renderer)
             return (tup.0, tup.1, self.legendLabels)
         }
-        layout.drawBackground(plan, renderer: renderer)
+        // Everything around the data is drawn as layers which the renderer may cache, unless
+        // layout components are being debugged in random colors.
+        let layerKeys = renderer.cachesLayers && renderer.debugLayoutComponents == nil ?
+            layout.layerKeys(plan, renderer: renderer) : nil
+        layout.drawBackground(plan, layerKey: layerKeys?.background, renderer: renderer)
+        let clipsData = layout.clipsDataToPlotRect || layout.hasVisibleRanges
         renderer.withAdditionalOffset(plan.plotBorderRect.origin) { renderer in
+            if clipsData {
+                renderer.setClipRect(Rect(origin: .zero, size: plan.plotBorderRect.size))
+            }
             drawData(drawingData, size: plan.plotBorderRect.size, renderer: renderer)
+            if clipsData {
+                renderer.setClipRect(nil)
+            }
         }
-        layout.drawForeground(plan, renderer: renderer)
+        layout.drawForeground(plan, layerKey: layerKeys?.foreground, renderer: renderer)
+        return (drawingData, plan)
     }
 
     public mutating func addAnnotation(annotation: Annotation) {
@@ -0,0 +1,185 @@
+import Foundation
+
+fileprivate let sqrt3: Float = sqrt(3)
+
+/// A hexbin plot counts 2-dimensional points into a grid of hexagons covering the plot,
+/// and shades each hexagon by the number of points in it using `colorMap`.
+///
+/// The points are counted in a single pass, so that large data sets can be plotted
+/// quickly: however many points there are, no more hexagons are drawn than fit in the
+/// plot at the given `hexagonRadius`.
+public struct HexbinPlot<T:FloatConvertible,U:FloatConvertible>: Plot {
+
+    public var layout = GraphLayout()
+    // Data.
+    var points = [Pair<T,U>]()
+    // Hexbin layout properties.
+    /// The distance from the centre of each hexagon to its corners.
+    public var hexagonRadius: Float = 10
+    public var colorMap: ColorMap = .viridis
+    /// How the count of each hexagon is mapped to an offset in `colorMap`.
+    public var normalization: DensityRendering.Normalization = .linear
+
+    public init(enableGrid: Bool = false){
+        self.enableGrid = enableGrid
+        // Hexagons along the edges reach beyond the plot area.
+        self.clipsDataToPlotRect = true
+    }
+
+    public init(points: [Pair<T,U>],
+                hexagonRadius: Float = 10,
+                enableGrid: Bool = false){
+        self.init(enableGrid: enableGrid)
+        self.points = points
+        self.hexagonRadius = hexagonRadius
+    }
+}
+
+// Setting data.
+
+extension HexbinPlot {
+
+    public mutating func addPoints(_ points: [Pair<T,U>]){
+        self.points.append(contentsOf: points)
+    }
+    public mutating func addPoints(_ x: [T], _ y: [U]){
+        precondition(x.count == y.count, "HexbinPlot.addPoints: expected as many y values as x values.")
+        points.append(contentsOf: zip(x, y).map { Pair($0, $1) })
+    }
+}
+
+// Layout properties.
+
+extension HexbinPlot {
+
+    public var enableGrid: Bool {
+        get { layout.enablePrimaryAxisGrid }
+        set { layout.enablePrimaryAxisGrid = newValue }
+    }
+}
+
+// Layout and drawing of data.
+
+extension HexbinPlot: HasGraphLayout {
+
+    public struct DrawingData {
+        var grid: HexagonGrid?
+    }
+
+    // functions implementing plotting logic
+    public func layoutData(size: Size, renderer: Renderer) -> (DrawingData, PlotMarkers?) {
+        var results = DrawingData()
+        var markers = PlotMarkers()
+        guard !points.isEmpty else { return (results, markers) }
+
+        // The axes are laid out like a line graph's.
+        let axisInfo = LineGraph<T,U>.AxisLayoutInfo(series: [Series(values: points, label: "")], size: size)
+        (markers.xMarkers, markers.xMarkersText, markers.yMarkers, markers.yMarkersText) =
+            axisInfo.calculateMarkers()
+
+        var grid = HexagonGrid(size: size, radius: hexagonRadius)
+        grid.add(points, transform: axisInfo.transform)
+        results.grid = grid
+        return (results, markers)
+    }
+
+    //functions to draw the plot
+    public func drawData(_ data: DrawingData, size: Size, renderer: Renderer) {
+        guard let grid = data.grid else { return }
+        for (index, offset) in normalization.offsets(for: grid.counts).enumerated() {
+            guard let offset = offset else { continue }
+            let hexagon = Polygon(hexagonPoints(center: grid.center(ofCell: index), radius: grid.radius))!
+            renderer.drawSolidPolygon(hexagon,
+                                      fillColor: colorMap.colorForOffset(offset))
+        }
+    }
+}
+
+/// The number of points in each cell of a grid of hexagons with a corner at the top.
+/// Rows of hexagons are `1.5 * radius` apart, and odd rows are shifted right by half a
+/// hexagon, so cell `(column, row)` is centred on
+/// `(sqrt(3) * radius * (column + (row & 1) / 2), 1.5 * radius * row)`. The grid covers
+/// `size` with one extra row and column of cells on every side.
+struct HexagonGrid {
+    let radius: Float
+    let columns: Int
+    let rows: Int
+    var counts: [UInt32]
+
+    // Points are transformed into positions this many at a time.
+    private static let blockSize = 4096
+
+    init(size: Size, radius: Float) {
+        precondition(radius > 0, "HexagonGrid: the radius must be positive.")
+        self.radius = radius
+        columns = Int(size.width / (sqrt3 * radius)) + 3
+        rows = Int(size.height / (1.5 * radius)) + 3
+        counts = [UInt32](repeating: 0, count: columns * rows)
+    }
+
+    func center(ofCell index: Int) -> Point {
+        let row = index / columns - 1
+        let column = index % columns - 1
+        return Point(sqrt3 * radius * (Float(column) + Float(row & 1) * 0.5),
+                     1.5 * radius * Float(row))
+    }
+
+    /// The index of the cell containing the position `(x, y)`, or `nil` if it is outside
+    /// the grid. The position is converted to fractional axial coordinates, which are
+    /// rounded to the nearest hexagon in constant time.
+    func cell(_ x: Float, _ y: Float) -> Int? {
+        let q = (x * sqrt3 / 3 - y / 3) / radius
+        let r = y * 2 / 3 / radius
+        let s = -q - r
+        var (roundedQ, roundedR) = (q.rounded(), r.rounded())
+        let roundedS = s.rounded()
+        let (dq, dr, ds) = (abs(roundedQ - q), abs(roundedR - r), abs(roundedS - s))
+        if dq > dr && dq > ds {
+            roundedQ = -roundedR - roundedS
+        } else if dr > ds {
+            roundedR = -roundedQ - roundedS
+        }
+        // Also rejects NaNs, before they reach the conversions to Int.
+        guard roundedR >= -1 && roundedR <= Float(rows - 2),
+            abs(roundedQ) <= Float(columns + rows) else { return nil }
+        let row = Int(roundedR)
+        let column = Int(roundedQ) + (row - (row & 1)) / 2
+        guard column >= -1 && column <= columns - 2 else { return nil }
+        return (row + 1) * columns + column + 1
+    }
+
+    /// Counts `points`, placed by `transform`. Long series are counted in chunks
+    /// concurrently, each into its own grid.
+    mutating func add<T, U>(_ points: [Pair<T,U>], transform: CoordinateTransform<T,U>) {
+        guard !points.isEmpty else { return }
+        let grid = self
+        let counted = reduceConcurrently(count: points.count, { range -> [UInt32] in
+            var counts = [UInt32](repeating: 0, count: grid.counts.count)
+            let xs = UnsafeMutablePointer<Float>.allocate(capacity: HexagonGrid.blockSize)
+            let ys = UnsafeMutablePointer<Float>.allocate(capacity: HexagonGrid.blockSize)
+            defer {
+                xs.deallocate()
+                ys.deallocate()
+            }
+            points.withUnsafeBufferPointer { buffer in
+                var start = range.lowerBound
+                while start < range.upperBound {
+                    let end = min(start + HexagonGrid.blockSize, range.upperBound)
+                    transform.apply(UnsafeBufferPointer(rebasing: buffer[start..<end]), xs: xs, ys: ys)
+                    for index in 0..<(end - start) {
+                        if let cell = grid.cell(xs[index], ys[index]) {
+                            counts[cell] &+= 1
+                        }
+                    }
+                    start = end
+                }
+            }
+            return counts
+        }, combine: { a, b in
+            var sum = a
+            for index in sum.indices { sum[index] &+= b[index] }
+            return sum
+        })
+        for index in counts.indices { counts[index] &+= counted[index] }
+    }
+}
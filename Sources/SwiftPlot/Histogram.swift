@@ -248,15 +248,19 @@ extension Histogram: HasGraphLayout {
             let xValues = stride(from: xStart, to: xStart + Float(binCount) * data.barWidth, by: data.barWidth)
             
             // Iterate through each bar stacking the corresponding bar of each series.
+            // The bars are drawn together, so that stacked segments can be filled in one pass.
+            var rects = [Rect]()
+            var fillColors = [Color]()
             for (x, binIdx) in zip(xValues, 0..<binCount) {
                 var currentHeight: Float = 0.0
                 for seriesIdx in allSeriesInfo.indices {
                     let height = allSeries[seriesIdx][binIdx]
-                    let rect = Rect(origin: Point(x, currentHeight), size: Size(width: data.barWidth, height: height))
-                    renderer.drawSolidRect(rect, fillColor: allSeriesInfo[seriesIdx].color, hatchPattern: .none)
+                    rects.append(Rect(origin: Point(x, currentHeight), size: Size(width: data.barWidth, height: height)))
+                    fillColors.append(allSeriesInfo[seriesIdx].color)
                     currentHeight += height
                 }
             }
+            renderer.drawSolidRects(rects, fillColors: fillColors)
         case .step:
             /// Accumulate the frequencies of each series.
             // One heights array for each series.
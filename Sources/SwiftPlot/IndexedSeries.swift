@@ -0,0 +1,301 @@
+import Foundation
+
+// The number of entries of each pyramid level which are summarised by a node of the next.
+fileprivate let INDEX_FANOUT = 16
+// Index files start with this, followed by the number of points, the fanout, the stride
+// of a point and the name of the point type, zero-padded to INDEX_HEADER_SIZE bytes.
+fileprivate let INDEX_MAGIC = Array("SWPLIDX1".utf8)
+fileprivate let INDEX_HEADER_SIZE = 128
+
+/// A long series of points sorted by x, indexed by a pyramid of the smallest and largest y
+/// values in each stretch of it, so that any x-range can be summarised without reading
+/// every point in it.
+///
+/// The first level of the pyramid has a node for each 16 consecutive points, and each
+/// further level a node for each 16 nodes of the level below, up to a single node for the
+/// whole series. A node holds the indices of its lowest and highest points; its first and
+/// last points are those at the ends of the stretch it covers. The bounds of any x-range
+/// are then found from `O(log(count))` entries, and `decimated(in:columns:)` reads
+/// `O(columns * log(count))` entries, however many points the range holds.
+///
+/// The points and the pyramid are kept in a single block of memory laid out like the file
+/// written by `write(to:)`, so that a series indexed once can be memory-mapped back with
+/// `init(contentsOf:)` instead of being read or indexed again. Index files use the byte
+/// order and point layout of the machine which wrote them.
+public struct IndexedSeries<T,U> {
+    let storage: IndexStorage
+    /// The points, sorted by x.
+    let samples: UnsafeBufferPointer<Pair<T,U>>
+    /// The levels of the pyramid, from the one summarising the points up to a single node.
+    let levels: [UnsafeBufferPointer<IndexNode>]
+
+    private init(storage: IndexStorage, count: Int) {
+        let layout = IndexedSeries.layout(count: count)
+        self.storage = storage
+        samples = UnsafeBufferPointer(start: (storage.base + INDEX_HEADER_SIZE).bindMemory(to: Pair<T,U>.self,
+                                                                                         capacity: count),
+                                      count: count)
+        levels = zip(layout.levelOffsets, layout.levelCounts).map { offset, count in
+            UnsafeBufferPointer(start: (storage.base + offset).bindMemory(to: IndexNode.self, capacity: count),
+                                count: count)
+        }
+    }
+
+    public var count: Int {
+        return samples.count
+    }
+
+    public subscript(index: Int) -> Pair<T,U> {
+        return samples[index]
+    }
+
+    /// The byte offsets and node counts of the pyramid's levels for `count` points, and the
+    /// size of the whole block.
+    private static func layout(count: Int) -> (levelOffsets: [Int], levelCounts: [Int], size: Int) {
+        var offset = INDEX_HEADER_SIZE + count * MemoryLayout<Pair<T,U>>.stride
+        offset = (offset + 15) / 16 * 16
+        var (levelOffsets, levelCounts) = ([Int](), [Int]())
+        var entries = count
+        repeat {
+            entries = (entries + INDEX_FANOUT - 1) / INDEX_FANOUT
+            levelOffsets.append(offset)
+            levelCounts.append(entries)
+            offset += entries * MemoryLayout<IndexNode>.stride
+        } while entries > 1
+        return (levelOffsets, levelCounts, offset)
+    }
+
+    private static func header(count: Int) -> [UInt8] {
+        var header = [UInt8](repeating: 0, count: INDEX_HEADER_SIZE)
+        header.replaceSubrange(0..<8, with: INDEX_MAGIC)
+        for (field, value) in [count, INDEX_FANOUT, MemoryLayout<Pair<T,U>>.stride].enumerated() {
+            var value = value
+            withUnsafeBytes(of: &value) { header.replaceSubrange(8 * (field + 1)..<8 * (field + 2), with: $0) }
+        }
+        let typeName = Array("\(T.self),\(U.self)".utf8.prefix(INDEX_HEADER_SIZE - 32))
+        header.replaceSubrange(32..<32 + typeName.count, with: typeName)
+        return header
+    }
+}
+
+extension IndexedSeries where T: FloatConvertible, U: FloatConvertible {
+
+    /// Indexes `values`, which must be sorted by x.
+    public init(values: [Pair<T,U>]) {
+        precondition(!values.isEmpty, "IndexedSeries: expected at least 1 point.")
+        let layout = IndexedSeries.layout(count: values.count)
+        let storage = IndexStorage(allocating: layout.size)
+        let base = UnsafeMutableRawPointer(mutating: storage.base)
+        IndexedSeries.header(count: values.count).withUnsafeBytes {
+            base.copyMemory(from: $0.baseAddress!, byteCount: $0.count)
+        }
+        let samplesEnd = values.withUnsafeBytes { values -> Int in
+            (base + INDEX_HEADER_SIZE).copyMemory(from: values.baseAddress!, byteCount: values.count)
+            return INDEX_HEADER_SIZE + values.count
+        }
+        // Zero the padding before the pyramid, so that index files are reproducible.
+        (base + samplesEnd).initializeMemory(as: UInt8.self, repeating: 0, count: layout.levelOffsets[0] - samplesEnd)
+        self.init(storage: storage, count: values.count)
+        buildPyramid()
+    }
+
+    /// Maps the index file at `url`, written by `write(to:)` for a series of the same
+    /// point type, into memory. Points are only read from the file when they are used.
+    public init(contentsOf url: URL) throws {
+        let storage = try IndexStorage(mapping: url)
+        guard storage.size >= INDEX_HEADER_SIZE else {
+            throw IndexedSeriesFileError(description: "\(url.path) is not an index file.")
+        }
+        let count = storage.base.load(fromByteOffset: 8, as: Int.self)
+        guard count > 0, UnsafeRawBufferPointer(start: storage.base, count: INDEX_HEADER_SIZE)
+            .elementsEqual(IndexedSeries.header(count: count)) else {
+            throw IndexedSeriesFileError(description: "\(url.path) is not an index file of \(Pair<T,U>.self) points.")
+        }
+        guard storage.size == IndexedSeries.layout(count: count).size else {
+            throw IndexedSeriesFileError(description: "\(url.path) is truncated.")
+        }
+        self.init(storage: storage, count: count)
+    }
+
+    /// Writes the points and the pyramid to an index file at `url`.
+    public func write(to url: URL) throws {
+        try Data(bytesNoCopy: UnsafeMutableRawPointer(mutating: storage.base), count: storage.size,
+                 deallocator: .none).write(to: url)
+    }
+
+    /// The x values of the first and last points.
+    public var xRange: ClosedRange<T> {
+        return samples[0].x...samples[count - 1].x
+    }
+
+    /// Returns the bounds of the points within `xRange`, or of every point if it is `nil`,
+    /// or `nil` if there are no points within `xRange`.
+    public func bounds(in xRange: ClosedRange<T>? = nil) -> (x: ClosedRange<T>, y: ClosedRange<U>)? {
+        let range = indices(in: xRange)
+        guard !range.isEmpty else { return nil }
+        let extremes = self.extremes(of: range)
+        return (x: samples[range.lowerBound].x...samples[range.upperBound - 1].x,
+                y: samples[extremes.minIndex].y...samples[extremes.maxIndex].y)
+    }
+
+    /// Returns the points which draw the same line as the points within `xRange` (or every
+    /// point if it is `nil`) when it is split into `columns` equal columns: the first, last,
+    /// lowest and highest points of each column, in order. The points either side of
+    /// `xRange` are included too, so that the line reaches its edges.
+    public func decimated(in xRange: ClosedRange<T>? = nil, columns: Int) -> [Pair<T,U>] {
+        precondition(columns > 0, "IndexedSeries.decimated: expected at least 1 column.")
+        let range = indices(in: xRange)
+        let lower = Double(xRange?.lowerBound ?? samples[0].x)
+        let columnWidth = (Double(xRange?.upperBound ?? samples[count - 1].x) - lower) / Double(columns)
+        var results = [Pair<T,U>]()
+        results.reserveCapacity(4 * columns + 2)
+        if range.lowerBound > 0 {
+            results.append(samples[range.lowerBound - 1])
+        }
+        var columnStart = range.lowerBound
+        for column in 1...columns {
+            let boundary = lower + Double(column) * columnWidth
+            let columnEnd = column == columns ? range.upperBound
+                : partitionPoint(in: columnStart..<range.upperBound) { Double($0.x) < boundary }
+            if columnStart < columnEnd {
+                let extremes = self.extremes(of: columnStart..<columnEnd)
+                var previous = -1
+                for index in [columnStart, extremes.minIndex, extremes.maxIndex, columnEnd - 1].sorted()
+                    where index != previous {
+                    results.append(samples[index])
+                    previous = index
+                }
+            }
+            columnStart = columnEnd
+        }
+        if range.upperBound < count {
+            results.append(samples[range.upperBound])
+        }
+        return results
+    }
+
+    /// The indices of the points within `xRange`, or of every point if it is `nil`.
+    private func indices(in xRange: ClosedRange<T>?) -> Range<Int> {
+        guard let xRange = xRange else { return 0..<count }
+        let start = partitionPoint(in: 0..<count) { $0.x < xRange.lowerBound }
+        return start..<partitionPoint(in: start..<count) { $0.x <= xRange.upperBound }
+    }
+
+    /// The first index in `range` whose point is not `isBefore`, which must hold for a
+    /// prefix of the points in `range`.
+    private func partitionPoint(in range: Range<Int>, _ isBefore: (Pair<T,U>) -> Bool) -> Int {
+        var (low, high) = (range.lowerBound, range.upperBound)
+        while low < high {
+            let middle = low + (high - low) / 2
+            if isBefore(samples[middle]) {
+                low = middle + 1
+            } else {
+                high = middle
+            }
+        }
+        return low
+    }
+
+    /// The indices of the lowest and highest points in `range`, found from the fewest nodes
+    /// of the pyramid which cover it.
+    func extremes(of range: Range<Int>) -> IndexNode {
+        var result = IndexNode(minIndex: range.lowerBound, maxIndex: range.lowerBound)
+        var (level, low, high) = (-1, range.lowerBound, range.upperBound)
+        while low < high {
+            // The entries before the first whole node of the next level, and after the last,
+            // are read at this level.
+            let nodesStart = (low + INDEX_FANOUT - 1) / INDEX_FANOUT * INDEX_FANOUT
+            let nodesEnd = high / INDEX_FANOUT * INDEX_FANOUT
+            guard level + 1 < levels.count, nodesStart < nodesEnd else {
+                merge(level: level, low..<high, into: &result)
+                break
+            }
+            merge(level: level, low..<nodesStart, into: &result)
+            merge(level: level, nodesEnd..<high, into: &result)
+            (level, low, high) = (level + 1, nodesStart / INDEX_FANOUT, nodesEnd / INDEX_FANOUT)
+        }
+        return result
+    }
+
+    /// Merges the extremes of entries `range` of pyramid level `level` into `result`, where
+    /// level -1 is the points themselves.
+    private func merge(level: Int, _ range: Range<Int>, into result: inout IndexNode) {
+        for index in range {
+            let entry = level < 0 ? IndexNode(minIndex: index, maxIndex: index) : levels[level][index]
+            if samples[entry.minIndex].y < samples[result.minIndex].y { result.minIndex = entry.minIndex }
+            if samples[entry.maxIndex].y > samples[result.maxIndex].y { result.maxIndex = entry.maxIndex }
+        }
+    }
+
+    /// Fills in the pyramid's levels from the bottom up. Long levels are filled in chunks
+    /// concurrently.
+    private func buildPyramid() {
+        for level in levels.indices {
+            let nodes = UnsafeMutablePointer(mutating: levels[level].baseAddress!)
+            let entriesBelow = level == 0 ? count : levels[level - 1].count
+            reduceConcurrently(count: levels[level].count, { (range: Range<Int>) -> Void in
+                for node in range {
+                    let start = node * INDEX_FANOUT
+                    let end = min(start + INDEX_FANOUT, entriesBelow)
+                    if level == 0 {
+                        for index in max(start, 1)..<end {
+                            precondition(!(samples[index].x < samples[index - 1].x),
+                                         "IndexedSeries: expected points sorted by x.")
+                        }
+                    }
+                    var extremes = level == 0 ? IndexNode(minIndex: start, maxIndex: start) : levels[level - 1][start]
+                    merge(level: level - 1, start + 1..<end, into: &extremes)
+                    nodes[node] = extremes
+                }
+            }, combine: { _, _ in })
+        }
+    }
+}
+
+/// A node of an `IndexedSeries` pyramid: the indices of the lowest and highest points in
+/// the stretch of the series it covers.
+struct IndexNode {
+    var minIndex: Int
+    var maxIndex: Int
+}
+
+public struct IndexedSeriesFileError: Error, CustomStringConvertible {
+    public let description: String
+}
+
+/// A block of memory holding an `IndexedSeries`, either allocated or mapped from a file.
+final class IndexStorage {
+    let base: UnsafeRawPointer
+    let size: Int
+    private let isMapped: Bool
+
+    init(allocating size: Int) {
+        base = UnsafeRawPointer(UnsafeMutableRawPointer.allocate(byteCount: size, alignment: 16))
+        self.size = size
+        isMapped = false
+    }
+
+    init(mapping url: URL) throws {
+        let descriptor = open(url.path, O_RDONLY)
+        guard descriptor >= 0 else {
+            throw IndexedSeriesFileError(description: "Could not open \(url.path).")
+        }
+        defer { close(descriptor) }
+        let size = Int(lseek(descriptor, 0, SEEK_END))
+        guard size > 0, let address = mmap(nil, size, PROT_READ, MAP_PRIVATE, descriptor, 0),
+            address != UnsafeMutableRawPointer(bitPattern: -1) else {
+            throw IndexedSeriesFileError(description: "Could not map \(url.path).")
+        }
+        base = UnsafeRawPointer(address)
+        self.size = size
+        isMapped = true
+    }
+
+    deinit {
+        if isMapped {
+            munmap(UnsafeMutableRawPointer(mutating: base), size)
+        } else {
+            base.deallocate()
+        }
+    }
+}
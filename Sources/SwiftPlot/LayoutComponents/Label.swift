@@ -4,7 +4,7 @@ public struct Label: LayoutComponent {
     var color: Color = .black
 
     public func measure(edge: RectEdge, _ renderer: Renderer) -> Size {
-        let hSize = renderer.getTextLayoutSize(text: text, textSize: size)
+        let hSize = renderer.getCachedTextLayoutSize(text: text, textSize: size)
         return edge.isHorizontal ? hSize : hSize.swappingComponents()
     }
     public func draw(_ rect: Rect, measuredSize: Size, edge: RectEdge, renderer: Renderer) {
@@ -11,6 +11,16 @@ public struct LineGraph<T:FloatConvertible,U:FloatConvertible>: Plot {
     var secondaryAxis: Axis<T,U>? = nil
     // Linegraph layout properties.
     public var plotLineThickness: Float = 1.5
+    /// The range of x values to show, or `nil` to show every point. Lines outside it are
+    /// clipped, and series added as an `IndexedSeries` are only read within it.
+    public var visibleXRange: ClosedRange<T>? = nil {
+        didSet { layout.hasVisibleRanges = visibleXRange != nil || visibleYRange != nil }
+    }
+    /// The range of y values to show on the primary axis, or `nil` to fit the points shown.
+    /// Lines outside it are clipped.
+    public var visibleYRange: ClosedRange<U>? = nil {
+        didSet { layout.hasVisibleRanges = visibleXRange != nil || visibleYRange != nil }
+    }
     
     public init(enablePrimaryAxisGrid: Bool = false,
                 enableSecondaryAxisGrid: Bool = false){
@@ -49,6 +59,16 @@ extension LineGraph {
         let s = Series<T,U>(values: points,label: label, color: color)
         addSeries(s, axisType: axisType)
     }
+    /// Adds a series whose bounds are found, and whose points are decimated to the plot's
+    /// width before drawing, using the pyramid of `values`.
+    public mutating func addSeries(_ values: IndexedSeries<T,U>,
+                          label: String,
+                          color: Color = Color.lightBlue,
+                          axisType: Axis<T,U>.Location = .primaryAxis){
+        var s = Series<T,U>(values: [], label: label, color: color)
+        s.indexedValues = values
+        addSeries(s, axisType: axisType)
+    }
     public mutating func addSeries(_ y: [U],
                           label: String,
                           color: Color = Color.lightBlue,
@@ -131,11 +151,12 @@ extension LineGraph: HasGraphLayout {
   public func layoutData(size: Size, renderer: Renderer) -> (DrawingData, PlotMarkers?) {
     var results = DrawingData()
     var markers = PlotMarkers()
-    guard !primaryAxis.series.isEmpty, !primaryAxis.series[0].values.isEmpty else { return (results, markers) }
+    guard !primaryAxis.series.isEmpty, primaryAxis.series[0].count > 0 else { return (results, markers) }
     
-    results.primaryAxisInfo   = AxisLayoutInfo(series: primaryAxis.series, size: size)
+    results.primaryAxisInfo   = AxisLayoutInfo(series: primaryAxis.series, size: size,
+                                                 xRange: visibleXRange, yRange: visibleYRange)
     results.secondaryAxisInfo = secondaryAxis.map {
-      var info = AxisLayoutInfo(series: $0.series, size: size)
+      var info = AxisLayoutInfo(series: $0.series, size: size, xRange: visibleXRange)
       info.mergeXAxis(with: &results.primaryAxisInfo!)
       return info
     }
@@ -153,11 +174,14 @@ extension LineGraph: HasGraphLayout {
   public func drawData(_ data: DrawingData, size: Size, renderer: Renderer) {
     if let axisInfo = data.primaryAxisInfo {
       for dataset in primaryAxis.series {
-        let points = dataset.values.map { axisInfo.convertCoordinate(fromData: $0) }
-        guard let polyline = Polyline(points) else {
-            fatalError("LineChart.drawData: Expecting 2 or more points, got \(points.count) instead")
+        let values = plottedValues(dataset, axisInfo: axisInfo)
+        guard values.count >= 2 else {
+            // An indexed series may just have no points in view.
+            if dataset.indexedValues != nil { continue }
+            fatalError("LineChart.drawData: Expecting 2 or more points, got \(values.count) instead")
         }
-        renderer.drawPolyline(polyline,
+        renderer.drawPolyline(values,
+                              transform: axisInfo.transform,
                               strokeWidth: plotLineThickness,
                               strokeColor: dataset.color,
                               isDashed: false)
@@ -165,17 +189,28 @@ extension LineGraph: HasGraphLayout {
     }
     if let secondaryAxis = secondaryAxis, let axisInfo = data.secondaryAxisInfo {
       for dataset in secondaryAxis.series {
-        let points = dataset.values.map { axisInfo.convertCoordinate(fromData: $0) }
-        guard let polyline = Polyline(points) else {
-            fatalError("LineChart.drawData: Expecting 2 or more points, got \(points.count) instead")
+        let values = plottedValues(dataset, axisInfo: axisInfo)
+        guard values.count >= 2 else {
+            // An indexed series may just have no points in view.
+            if dataset.indexedValues != nil { continue }
+            fatalError("LineChart.drawData: Expecting 2 or more points, got \(values.count) instead")
         }
-        renderer.drawPolyline(polyline,
+        renderer.drawPolyline(values,
+                              transform: axisInfo.transform,
                               strokeWidth: plotLineThickness,
                               strokeColor: dataset.color,
                               isDashed: true)
       }
     }
   }
+  
+  /// The points of `series` to draw. An indexed series is decimated to the first, last,
+  /// lowest and highest points in each pixel column of the plot, which draw the same line.
+  private func plottedValues(_ series: Series<T,U>, axisInfo: AxisLayoutInfo) -> [Pair<T,U>] {
+    guard let indexedValues = series.indexedValues else { return series.values }
+    let columns = Int((axisInfo.size.width - 2 * axisInfo.rightMargin).rounded(.up))
+    return indexedValues.decimated(in: axisInfo.bounds.x, columns: max(columns, 1))
+  }
 }
 
 extension LineGraph {
@@ -193,30 +228,49 @@ extension LineGraph {
     var origin: Point = .zero
     var originValue = Pair(T(0), U(0))
     
-    init(series: [Series<T, U>], size: Size) {
+    /// Lays out `series` to fit `size`. If `xRange` is given, the x axis spans it and the y
+    /// axis spans the points within it, unless `yRange` is also given.
+    init(series: [Series<T, U>], size: Size, xRange: ClosedRange<T>? = nil, yRange: ClosedRange<U>? = nil) {
       self.size   = size
       rightMargin = size.width  * 0.05
       topMargin   = size.height * 0.05
-      bounds      = AxisLayoutInfo.getBounds(series)
+      if let xRange = xRange, let yRange = yRange {
+        bounds = (x: xRange, y: yRange)
+      } else {
+        bounds = AxisLayoutInfo.getBounds(series, xRange: xRange, yRange: yRange)
+      }
       boundsDidChange()
     }
     
-    private static func getBounds(_ series: [Series<T, U>]) -> (x: ClosedRange<T>, y: ClosedRange<U>) {
-      var maximumX: T = maxX(points: series[0].values)
-      var minimumX: T = minX(points: series[0].values)
-      var maximumY: U = maxY(points: series[0].values)
-      var minimumY: U = minY(points: series[0].values)
+    private static func getBounds(_ series: [Series<T, U>], xRange: ClosedRange<T>?,
+                                  yRange: ClosedRange<U>? = nil) -> (x: ClosedRange<T>, y: ClosedRange<U>) {
+      var bounds: (x: ClosedRange<T>, y: ClosedRange<U>)? = nil
       for s in series {
-        var x: T = maxX(points: s.values)
-        var y: U = maxY(points: s.values)
-        maximumX = max(x, maximumX)
-        maximumY = max(y, maximumY)
-        x = minX(points: s.values)
-        y = minY(points: s.values)
-        minimumX = min(x, minimumX)
-        minimumY = min(y, minimumY)
+        guard let b = getBounds(s, xRange: xRange) else { continue }
+        guard let previous = bounds else {
+          bounds = b
+          continue
+        }
+        bounds = (x: min(b.x.lowerBound, previous.x.lowerBound)...max(b.x.upperBound, previous.x.upperBound),
+                  y: min(b.y.lowerBound, previous.y.lowerBound)...max(b.y.upperBound, previous.y.upperBound))
       }
-      return (x: minimumX...maximumX, y: minimumY...maximumY)
+      if let bounds = bounds {
+        return (x: xRange ?? bounds.x, y: yRange ?? bounds.y)
+      }
+      // No points are within xRange, so fit the y axis to all of them.
+      guard let xRange = xRange else { fatalError("LineGraph: expected a series with at least 1 point.") }
+      return (x: xRange, y: yRange ?? getBounds(series, xRange: nil).y)
+    }
+    
+    private static func getBounds(_ series: Series<T, U>,
+                                  xRange: ClosedRange<T>?) -> (x: ClosedRange<T>, y: ClosedRange<U>)? {
+      if let indexedValues = series.indexedValues {
+        return indexedValues.bounds(in: xRange)
+      }
+      let values = xRange.map { xRange in series.values.filter { xRange.contains($0.x) } } ?? series.values
+      guard !values.isEmpty else { return nil }
+      let b = boundsXY(points: values)
+      return (x: b.minX...b.maxX, y: b.minY...b.maxY)
     }
     
     private mutating func boundsDidChange() {
@@ -412,9 +466,12 @@ extension LineGraph {
               y: yMarkerLocations, yLabels: yMarkerLabels)
     }
     
+    var transform: CoordinateTransform<T,U> {
+      return CoordinateTransform(originValue: originValue, origin: origin, scaleX: scaleX, scaleY: scaleY)
+    }
+    
     func convertCoordinate(fromData value: Pair<T,U>) -> Point {
-      return Point(Float(((value.x - originValue.x) / T(scaleX)) + T(origin.x)),
-                   Float(((value.y - originValue.y) / U(scaleY)) + U(origin.y)))
+      return transform.apply(value)
     }
     
     mutating func mergeXAxis(with other: inout AxisLayoutInfo) {
@@ -0,0 +1,306 @@
+import Foundation
+
+/// A line graph of series which are being appended to, such as readings streamed from
+/// sensors, which is drawn again to the same renderer after each batch of new points.
+///
+/// Each series keeps its most recent points in a `RingBufferSeries`, and the graph shows
+/// the last `windowWidth` of x values. On renderers which support incremental updates,
+/// drawing again only redraws the strip of the plot which the new points have changed,
+/// and the graph is only laid out and drawn in full when its axes change: when a new
+/// point falls outside the y axis, when the x axis moves on in `.sweep` mode, or once the
+/// plot has scrolled by its width in `.scroll` mode.
+///
+/// The x values of each series must not decrease, and each series should have room for
+/// the points of a whole window, or else every draw is a full one.
+public final class LiveLineGraph<T: FloatConvertible, U: FloatConvertible> {
+
+    /// How the x axis follows new points.
+    public enum UpdateMode {
+        /// The x axis stays put while new points are drawn across the plot, and jumps on by
+        /// three quarters of `windowWidth` once they reach its end.
+        case sweep
+        /// The plot scrolls left as new points arrive, so that the newest is always at the
+        /// right. The plot and the x-axis markers are moved rather than drawn again.
+        case scroll
+    }
+
+    /// What `draw(size:renderer:)` drew.
+    public enum Update {
+        /// The whole graph was laid out and drawn.
+        case full
+        /// The plot was scrolled, and only the x-axis markers and the new points were drawn.
+        case scrolled
+        /// Only the part of the plot with the new points was drawn.
+        case partial
+        /// No points had been added since the last draw, so nothing was drawn.
+        case unchanged
+    }
+
+    /// The graph which the series are drawn on, which sets the style of the graph. Its own
+    /// series and visible ranges are ignored.
+    public var graph: LineGraph<T,U> {
+        didSet { invalidate() }
+    }
+    public private(set) var series = [RingBufferSeries<T,U>]()
+    /// The range of x values shown.
+    public var windowWidth: T {
+        didSet { invalidate() }
+    }
+    public var mode: UpdateMode {
+        didSet { invalidate() }
+    }
+    /// The range of y values shown, or `nil` to fit the points shown, with a margin.
+    public var yRange: ClosedRange<U>? = nil {
+        didSet { invalidate() }
+    }
+
+    private struct DrawState {
+        let size: Size
+        // Held weakly and compared by identity, as a renderer freed since may be replaced by
+        // a new one at the same address.
+        weak var renderer: Renderer?
+        let graph: LineGraph<T,U>
+        var plan: GraphLayout.LayoutPlan
+        var axisInfo: LineGraph<T,U>.AxisLayoutInfo
+        let xRange: ClosedRange<T>
+        // The indices of the series which were drawn, and the `appendedCount` of each series.
+        let drawnSeries: [Int]
+        var drawnCounts: [Int]
+        // How far the plot has scrolled since it was drawn in full.
+        var scrolled: Float = 0
+    }
+    private var state: DrawState? = nil
+
+    public init(windowWidth: T, mode: UpdateMode = .sweep, graph: LineGraph<T,U> = LineGraph()) {
+        precondition(windowWidth > T(0), "LiveLineGraph: expected a positive window width.")
+        self.windowWidth = windowWidth
+        self.mode = mode
+        self.graph = graph
+    }
+}
+
+// Setting data.
+
+extension LiveLineGraph {
+
+    /// Adds a series which keeps its last `capacity` points, and returns its index.
+    @discardableResult
+    public func addSeries(capacity: Int, label: String, color: Color = .lightBlue) -> Int {
+        series.append(RingBufferSeries(capacity: capacity, label: label, color: color))
+        invalidate()
+        return series.count - 1
+    }
+
+    public func append(_ point: Pair<T,U>, toSeries index: Int) {
+        if let last = series[index].last {
+            precondition(point.x >= last.x, "LiveLineGraph.append: expected x values which do not decrease.")
+        }
+        series[index].append(point)
+    }
+
+    public func append<S: Sequence>(contentsOf points: S, toSeries index: Int) where S.Element == Pair<T,U> {
+        for point in points { append(point, toSeries: index) }
+    }
+
+    /// Makes the next draw a full one.
+    public func invalidate() {
+        state = nil
+    }
+}
+
+// Drawing.
+
+extension LiveLineGraph {
+
+    /// Draws the graph, redrawing only what has changed since the last draw if the
+    /// renderer supports incremental updates and still holds that draw.
+    @discardableResult
+    public func draw(size: Size, renderer: Renderer) -> Update {
+        if let previous = state, renderer.supportsIncrementalUpdates,
+            previous.size == size, previous.renderer === renderer,
+            let update = drawIncrementally(previous, renderer: renderer) {
+            return update
+        }
+        drawFully(size: size, renderer: renderer)
+        return .full
+    }
+
+    private var plottedSeries: [Int] {
+        return series.indices.filter { series[$0].count >= 2 }
+    }
+
+    private func drawFully(size: Size, renderer: Renderer) {
+        let plotted = plottedSeries
+        var graph = self.graph
+        graph.primaryAxis.series = plotted.map {
+            Series(values: Array(series[$0]), label: series[$0].label, color: series[$0].color)
+        }
+        graph.secondaryAxis = nil
+        let xRange = window()
+        graph.visibleXRange = xRange
+        graph.visibleYRange = yRange ?? fittedYRange(xRange, series: plotted)
+
+        let (data, plan) = graph.drawGraphKeepingLayout(size: size, renderer: renderer)
+        guard let axisInfo = data.primaryAxisInfo else {
+            state = nil
+            return
+        }
+        state = DrawState(size: size, renderer: renderer, graph: graph,
+                          plan: plan, axisInfo: axisInfo, xRange: xRange, drawnSeries: plotted,
+                          drawnCounts: series.map { $0.appendedCount })
+    }
+
+    /// Returns what was drawn, or `nil` if the graph must be drawn in full.
+    private func drawIncrementally(_ previous: DrawState, renderer: Renderer) -> Update? {
+        var state = previous
+        guard plottedSeries == state.drawnSeries else { return nil }
+        let counts = series.map { $0.appendedCount }
+        if counts == state.drawnCounts { return .unchanged }
+
+        let plotSize = state.plan.plotBorderRect.size
+        let leftEdge = xValue(atPosition: 0, state.axisInfo)
+        // The positions of the last points drawn before and of the newest points.
+        var lastDrawn = Float.infinity
+        var newest = -Float.infinity
+        for index in state.drawnSeries {
+            let ring = series[index]
+            let added = counts[index] - state.drawnCounts[index]
+            guard added > 0 else { continue }
+            // The last point drawn, or points still in view, have been replaced.
+            guard added < ring.count else { return nil }
+            if ring.count == ring.capacity && ring[0].x > leftEdge { return nil }
+            if yRange == nil {
+                for point in ring[(ring.count - added)...] where !state.axisInfo.bounds.y.contains(point.y) {
+                    return nil
+                }
+            }
+            lastDrawn = min(lastDrawn, state.axisInfo.convertCoordinate(fromData: ring[ring.count - added - 1]).x)
+            newest = max(newest, state.axisInfo.convertCoordinate(fromData: ring[ring.count - 1]).x)
+        }
+
+        guard lastDrawn <= newest else {
+            // Only series which are not drawn yet have new points.
+            self.state?.drawnCounts = counts
+            return .unchanged
+        }
+
+        let padding = lineJoinPadding
+        var maxX = newest + padding
+        var update = Update.partial
+        switch mode {
+        case .sweep:
+            guard series.allSatisfy({ $0.last.map { $0.x <= state.xRange.upperBound } ?? true }) else { return nil }
+        case .scroll:
+            let shift = (newest - (plotSize.width - state.axisInfo.rightMargin)).rounded(.up)
+            if shift > 0 {
+                guard scroll(&state, by: shift, renderer: renderer) else { return nil }
+                // The part of the plot which was scrolled into view is drawn along with the new points.
+                lastDrawn = min(lastDrawn - shift, plotSize.width - shift)
+                maxX = plotSize.width
+                update = .scrolled
+            }
+        }
+        redraw(Rect(origin: Point(lastDrawn - padding, 0),
+                    size: Size(width: maxX - lastDrawn + padding, height: plotSize.height)),
+               state, renderer: renderer)
+        state.drawnCounts = counts
+        self.state = state
+        return update
+    }
+
+    /// Scrolls the plot and the x axis left by `shift`, and redraws the x-axis markers and
+    /// the legend. Returns `false`, having drawn nothing, if the graph must be drawn in full.
+    private func scroll(_ state: inout DrawState, by shift: Float, renderer: Renderer) -> Bool {
+        let layout = state.graph.layout
+        let plotRect = state.plan.plotBorderRect
+        guard state.scrolled + shift <= plotRect.width, layout.annotations.isEmpty else { return false }
+
+        // Move the x axis with the plot, and check that the grid lines which are moved are
+        // where the new markers put them.
+        var axisInfo = state.axisInfo
+        axisInfo.origin.x -= shift
+        let shiftValue = T(shift * axisInfo.scaleX)
+        axisInfo.bounds.x = (axisInfo.bounds.x.lowerBound + shiftValue)...(axisInfo.bounds.x.upperBound + shiftValue)
+        let markers = axisInfo.calculateMarkers()
+        let movedMarkers = state.plan.plotMarkers.xMarkers.map { $0 - shift }
+        for marker in markers.x where marker + shift <= plotRect.width {
+            guard movedMarkers.contains(where: { abs($0 - marker) < 0.01 }) else { return false }
+        }
+
+        renderer.moveRegion(plotRect, by: Point(-shift, 0))
+        state.axisInfo = axisInfo
+        state.scrolled += shift
+        layout.redrawXMarkers(markers.x, text: markers.xLabels, plan: &state.plan, renderer: renderer)
+        // The legend was moved along with the plot, so it is drawn again over both places.
+        if let legendRect = state.plan.legendRect {
+            let border = layout.plotLegend.borderThickness
+            redraw(Rect(origin: Point(legendRect.minX - plotRect.minX - shift - border,
+                                      legendRect.minY - plotRect.minY - border),
+                        size: Size(width: legendRect.width + shift + 2 * border,
+                                   height: legendRect.height + 2 * border)),
+                   state, renderer: renderer)
+        }
+        return true
+    }
+
+    // How far the joins and ends of the lines may reach beyond their points.
+    private var lineJoinPadding: Float {
+        return 2 * graph.plotLineThickness + 2
+    }
+
+    /// Redraws `rect` of the plot.
+    private func redraw(_ rect: Rect, _ state: DrawState, renderer: Renderer) {
+        // The lines are drawn from beyond the rect, so that their joins within it are drawn.
+        let minX = xValue(atPosition: rect.minX - lineJoinPadding, state.axisInfo)
+        let maxX = xValue(atPosition: rect.maxX + lineJoinPadding, state.axisInfo)
+        state.graph.layout.redrawPlotArea(rect, plan: state.plan, renderer: renderer) { renderer in
+            for index in state.drawnSeries {
+                let ring = series[index]
+                let points = Array(ring[ring.indices(around: minX...maxX)])
+                guard points.count >= 2 else { continue }
+                renderer.drawPolyline(points,
+                                      transform: state.axisInfo.transform,
+                                      strokeWidth: state.graph.plotLineThickness,
+                                      strokeColor: ring.color,
+                                      isDashed: false)
+            }
+        }
+    }
+
+    private func xValue(atPosition x: Float, _ axisInfo: LineGraph<T,U>.AxisLayoutInfo) -> T {
+        return axisInfo.originValue.x + T((x - axisInfo.origin.x) * axisInfo.scaleX)
+    }
+
+    /// The x range to show when the graph is drawn in full.
+    private func window() -> ClosedRange<T> {
+        let newest = series.compactMap { $0.last?.x }.max() ?? T(0)
+        switch mode {
+        case .sweep:
+            // The window moves on by three quarters of its width at a time, so that a quarter
+            // of it still shows older points when it does.
+            let width = windowWidth.toDouble()
+            let start = (newest.toDouble() / (0.75 * width)).rounded(.down) * 0.75 * width - 0.25 * width
+            return T(start)...T(start + width)
+        case .scroll:
+            return (newest - windowWidth)...newest
+        }
+    }
+
+    /// The range of the y values of `plotted` within `xRange`, or of all of them if there are
+    /// none in it, widened by a tenth on either side.
+    private func fittedYRange(_ xRange: ClosedRange<T>, series plotted: [Int]) -> ClosedRange<U> {
+        var low = Double.infinity
+        var high = -Double.infinity
+        for inRange in [true, false] where low > high {
+            for index in plotted {
+                for point in series[index] where !inRange || xRange.contains(point.x) {
+                    low = min(low, point.y.toDouble())
+                    high = max(high, point.y.toDouble())
+                }
+            }
+        }
+        guard low <= high else { return U(-1)...U(1) }
+        let margin = high > low ? 0.1 * (high - low) : 1
+        return U(low - margin)...U(high + margin)
+    }
+}
@@ -11,6 +11,22 @@ public struct Pair<T,U> {
 extension Pair: Equatable where T: Equatable, U: Equatable {}
 extension Pair: Hashable where T: Hashable, U: Hashable {}
 
+extension UnsafeBufferPointer {
+
+    /// Calls `body` with the pairs' x and y values as a single run of `2 * count` scalars,
+    /// `x0, y0, x1, y1, ...`, so that `Float` and `Double` pairs can be read without generic
+    /// arithmetic. The elements must be `Pair<S,S>`, and the buffer must not be empty.
+    func withInterleavedScalars<S, R>(of type: S.Type, _ body: (UnsafePointer<S>) throws -> R) rethrows -> R {
+        precondition(Element.self == Pair<S,S>.self, "withInterleavedScalars: expected Pair<\(S.self),\(S.self)> elements.")
+        precondition(MemoryLayout<Pair<S,S>>.stride == 2 * MemoryLayout<S>.stride,
+                     "withInterleavedScalars: expected Pair<\(S.self),\(S.self)> to hold just its x and y.")
+        guard let base = baseAddress else {
+            preconditionFailure("withInterleavedScalars: expected a non-empty buffer.")
+        }
+        return try base.withMemoryRebound(to: S.self, capacity: 2 * count, body)
+    }
+}
+
 public typealias Point = Pair<Float,Float>
 
 extension Point {
@@ -1,4 +1,4 @@
-public struct PlotMarkers{
+public struct PlotMarkers: Hashable {
     public var xMarkers = [Float]()
     public var yMarkers = [Float]()
     public var y2Markers = [Float]()
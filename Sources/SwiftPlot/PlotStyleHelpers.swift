@@ -1,17 +1,17 @@
 import Foundation
 
-public struct PlotBorder {
+public struct PlotBorder: Hashable {
     public var color = Color.black
     public var thickness: Float = 2
     public init() {}
 }
 
-public struct Grid {
+public struct Grid: Hashable {
     public var color = Color.gray
     public var thickness: Float = 0.5
 }
 
-public struct PlotTitle {
+public struct PlotTitle: Hashable {
     public var title = ""
     public var color = Color.black
     public var size: Float = 20
@@ -20,7 +20,7 @@ public struct PlotTitle {
     }
 }
 
-public struct PlotLabel {
+public struct PlotLabel: Hashable {
     public var xLabel = ""
     public var yLabel = ""
     public var y2Label = ""
@@ -34,7 +34,7 @@ public struct PlotLabel {
     }
 }
 
-public struct PlotLegend {
+public struct PlotLegend: Hashable {
     public var backgroundColor = Color.transluscentWhite
     public var borderColor = Color.black
     public var borderThickness: Float = 2
@@ -131,7 +131,7 @@ struct Text: Annotation, AnchorableAnnotation {
     }
     public mutating func draw(resolver: CoordinateResolver, renderer: Renderer) {
         if boundingBox != nil {
-            var bboxSize = renderer.getTextLayoutSize(text: text, textSize: size)
+            var bboxSize = renderer.getCachedTextLayoutSize(text: text, textSize: size)
             bboxSize.width += 2 * borderWidth
             bboxSize.height += 2 * borderWidth
             boundingBox?.location = Point(location.x - borderWidth, location.y - borderWidth)
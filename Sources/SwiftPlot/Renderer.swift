@@ -47,6 +47,35 @@ public protocol Renderer: AnyObject{
                        fillColor: Color,
                        hatchPattern: BarGraphSeriesOptions.Hatching)
 
+    /*drawSolidRects()
+    *params: rects: [Rect],
+    *        fillColors: [Color]
+    *description: Draws rectangles, each filled with the color at the same index
+    *             and without a border. Later rectangles are drawn on top of
+    *             earlier ones. Renderers may fill them all in a single pass, so
+    *             that edges shared by neighbouring rectangles, such as the
+    *             segments of a stacked bar, are drawn exactly. By default each
+    *             rectangle is drawn in turn with drawSolidRect.
+    */
+    func drawSolidRects(_ rects: [Rect],
+                        fillColors: [Color])
+
+    /*drawImage()
+    *params: pixels: [UInt8],
+    *        width: Int,
+    *        height: Int,
+    *        rect: Rect
+    *description: Draws an image of width by height pixels, stored as rows of RGBA bytes
+    *             with unpremultiplied alpha, stretched to fill the rectangle. The first
+    *             row is drawn at the bottom of the rectangle. By default, each run of
+    *             identical pixels in a row is drawn as a rectangle with drawSolidRects.
+    *             This function always operates in the coordinate system with the shifted origin.
+    */
+    func drawImage(_ pixels: [UInt8],
+                   width: Int,
+                   height: Int,
+                   in rect: Rect)
+
     /*drawLine()
     *params: startPoint p1: Point,
     *        endPoint p2: Point,
@@ -78,6 +107,22 @@ public protocol Renderer: AnyObject{
                       strokeWidth thickness: Float,
                       strokeColor: Color, isDashed: Bool)
 
+    /*drawPolyline()
+    *params: values: [Pair<T,U>],
+    *        transform: CoordinateTransform<T,U>,
+    *        strokeWidth thickness: Float,
+    *        strokeColor: Color,
+    *        isDashed: Bool
+    *description: Draws a data series as a polyline, mapping each value to its position with
+    *             'transform'. Renderers which draw from columns of coordinates can transform
+    *             the whole series straight into them.
+    *             This function always operates in the coordinate system with the shifted origin.
+    */
+    func drawPolyline<T, U>(_ values: [Pair<T,U>],
+                            transform: CoordinateTransform<T,U>,
+                            strokeWidth thickness: Float,
+                            strokeColor: Color, isDashed: Bool)
+
     /*drawText()
     *params: text s: String,
     *        location p: Point,
@@ -181,6 +226,66 @@ public protocol Renderer: AnyObject{
     */
     func getTextLayoutSize(text: String, textSize size: Float) -> Size
 
+    /*property: fontIdentifier
+    *description: Identifies the font used by getTextLayoutSize, so that cached
+    *             text measurements are not shared between different fonts.
+    *             Renderers whose font can change should return a different
+    *             value for each font. Defaults to an empty string.
+    */
+    var fontIdentifier: String { get }
+
+    /*setClipRect()
+    *params: rect: Rect?
+    *description: Limits drawing to the given rectangle, in the current offset's
+    *             coordinates, until it is called again with nil. Geometry which
+    *             falls entirely outside the rectangle may be left out before it
+    *             is stroked or filled, so data far outside the visible region
+    *             costs little to draw. Renderers which cannot clip may ignore
+    *             it. By default it does nothing.
+    */
+    func setClipRect(_ rect: Rect?)
+
+    /*property: supportsIncrementalUpdates
+    *description: Whether the renderer draws into pixels which stay drawn until they are
+    *             drawn over, clips to setClipRect and can move them with moveRegion, so
+    *             that a graph can be updated by redrawing only the region which changed.
+    *             Defaults to false.
+    */
+    var supportsIncrementalUpdates: Bool { get }
+
+    /*moveRegion()
+    *params: rect: Rect,
+    *        offset: Point
+    *description: Moves the whole pixels within the rectangle by the offset, rounded to
+    *             whole pixels. Pixels moved outside the rectangle are dropped, and the part
+    *             of it which nothing is moved into keeps its old pixels. Only called on
+    *             renderers which support incremental updates. By default it does nothing.
+    *             This function always operates in the coordinate system with the shifted origin.
+    */
+    func moveRegion(_ rect: Rect, by offset: Point)
+
+    /*property: cachesLayers
+    *description: Whether the renderer keeps the layers drawn with drawLayer, so that a layer
+    *             drawn again with the same key is copied instead of being drawn.
+    *             Defaults to false.
+    */
+    var cachesLayers: Bool { get }
+
+    /*drawLayer()
+    *params: key: Int,
+    *        rect: Rect,
+    *        isOpaque: Bool,
+    *        draw: (Renderer) -> Void
+    *description: Draws a layer of the image within the rectangle by calling 'draw', such as
+    *             the axes and labels of a graph which is drawn again with new data. Renderers
+    *             which cache layers copy the layer kept for 'key' instead, if they have one,
+    *             so the key must identify everything that 'draw' draws. An opaque layer covers
+    *             the whole rectangle, so it does not depend on what is beneath it.
+    *             By default, 'draw' is called.
+    *             This function always operates in the coordinate system with the shifted origin.
+    */
+    func drawLayer(_ key: Int, in rect: Rect, isOpaque: Bool, draw: (Renderer) -> Void)
+
     /*drawOutput()
     *params: fileName name: String
     *description: Saves the drawn image to disk
@@ -199,8 +304,67 @@ extension Renderer {
         get { return offset.y }
         set { offset.y = newValue}
     }
+    public var fontIdentifier: String {
+        return ""
+    }
+    public func drawSolidRects(_ rects: [Rect], fillColors: [Color]) {
+        precondition(rects.count == fillColors.count, "drawSolidRects: expected one fill color for each rect.")
+        for (rect, fillColor) in zip(rects, fillColors) {
+            drawSolidRect(rect, fillColor: fillColor, hatchPattern: .none)
+        }
+    }
+    public func setClipRect(_ rect: Rect?) {
+    }
+    public var supportsIncrementalUpdates: Bool {
+        return false
+    }
+    public func moveRegion(_ rect: Rect, by offset: Point) {
+    }
+    public var cachesLayers: Bool {
+        return false
+    }
+    public func drawLayer(_ key: Int, in rect: Rect, isOpaque: Bool, draw: (Renderer) -> Void) {
+        draw(self)
+    }
+    public func drawImage(_ pixels: [UInt8], width: Int, height: Int, in rect: Rect) {
+        precondition(pixels.count == width * height * 4, "drawImage: expected 4 bytes for each pixel.")
+        func pixel(_ index: Int) -> (UInt8, UInt8, UInt8, UInt8) {
+            return (pixels[4 * index], pixels[4 * index + 1], pixels[4 * index + 2], pixels[4 * index + 3])
+        }
+        let rect = rect.normalized
+        let pixelSize = Size(width: rect.size.width / Float(width), height: rect.size.height / Float(height))
+        var rects = [Rect]()
+        var fillColors = [Color]()
+        for row in 0..<height {
+            var column = 0
+            while column < width {
+                let (r, g, b, a) = pixel(row * width + column)
+                var end = column + 1
+                while end < width && pixel(row * width + end) == (r, g, b, a) {
+                    end += 1
+                }
+                if a != 0 {
+                    rects.append(Rect(origin: Point(rect.origin.x + Float(column) * pixelSize.width,
+                                                    rect.origin.y + Float(row) * pixelSize.height),
+                                      size: Size(width: Float(end - column) * pixelSize.width,
+                                                 height: pixelSize.height)))
+                    fillColors.append(Color(Float(r) / 255, Float(g) / 255, Float(b) / 255, Float(a) / 255))
+                }
+                column = end
+            }
+        }
+        drawSolidRects(rects, fillColors: fillColors)
+    }
+    public func drawPolyline<T, U>(_ values: [Pair<T,U>],
+                                   transform: CoordinateTransform<T,U>,
+                                   strokeWidth thickness: Float,
+                                   strokeColor: Color, isDashed: Bool) {
+        let (xs, ys) = transform.apply(values)
+        guard let polyline = Polyline(zip(xs, ys).map { Point($0, $1) }) else { return }
+        drawPolyline(polyline, strokeWidth: thickness, strokeColor: strokeColor, isDashed: isDashed)
+    }
     func getTextWidth(text: String, textSize size: Float) -> Float {
-        return getTextLayoutSize(text: text, textSize: size).width
+        return getCachedTextLayoutSize(text: text, textSize: size).width
     }
 
     public func withAdditionalOffset(_ offset: Point, _ perform: (Self) throws -> Void) rethrows {
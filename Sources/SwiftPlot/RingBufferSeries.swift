@@ -0,0 +1,78 @@
+/// A series which keeps only its most recent `capacity` points, such as the readings
+/// streamed from a sensor. Once the series is full, each point appended replaces the
+/// oldest, so appending never allocates.
+///
+/// The points are indexed from the oldest, at `0`, to the newest.
+public struct RingBufferSeries<T,U>: RandomAccessCollection {
+    public let capacity: Int
+    public var label: String
+    public var color: Color
+    private var storage = [Pair<T,U>]()
+    // The position in `storage` of the oldest point.
+    private var start = 0
+    /// The number of points appended to the series, including those which have since been
+    /// replaced by newer ones.
+    public private(set) var appendedCount = 0
+
+    public init(capacity: Int, label: String = "Plot", color: Color = .lightBlue) {
+        precondition(capacity > 0, "RingBufferSeries: expected a positive capacity.")
+        self.capacity = capacity
+        self.label = label
+        self.color = color
+        storage.reserveCapacity(capacity)
+    }
+
+    public var startIndex: Int { 0 }
+    public var endIndex: Int { storage.count }
+
+    public subscript(position: Int) -> Pair<T,U> {
+        precondition(indices.contains(position), "RingBufferSeries: index \(position) out of range.")
+        let index = start + position
+        return storage[index < capacity ? index : index - capacity]
+    }
+
+    public mutating func append(_ point: Pair<T,U>) {
+        if storage.count < capacity {
+            storage.append(point)
+        } else {
+            storage[start] = point
+            start = start + 1 < capacity ? start + 1 : 0
+        }
+        appendedCount += 1
+    }
+
+    public mutating func append<S: Sequence>(contentsOf points: S) where S.Element == Pair<T,U> {
+        for point in points { append(point) }
+    }
+
+    /// Removes every point, keeping `appendedCount`.
+    public mutating func removeAll() {
+        storage.removeAll(keepingCapacity: true)
+        start = 0
+    }
+}
+
+extension RingBufferSeries where T: FloatConvertible {
+
+    /// The indices of the points needed to draw the series over `xRange`: those within it,
+    /// and the last point before it and the first after it, if there are any. The points
+    /// must be sorted by x.
+    func indices(around xRange: ClosedRange<T>) -> Range<Int> {
+        // The first index whose point is not before `x`, or whose point is after it.
+        func partition(_ x: T, after: Bool) -> Int {
+            var (low, high) = (0, count)
+            while low < high {
+                let middle = (low + high) / 2
+                if after ? self[middle].x <= x : self[middle].x < x {
+                    low = middle + 1
+                } else {
+                    high = middle
+                }
+            }
+            return low
+        }
+        let lower = max(partition(xRange.lowerBound, after: false) - 1, 0)
+        let upper = min(partition(xRange.upperBound, after: true) + 1, count)
+        return lower..<max(upper, lower)
+    }
+}
@@ -12,6 +12,9 @@ public struct ScatterPlot<T:FloatConvertible,U:FloatConvertible>: Plot {
     // ScatterPlot layout properties.
     // public var plotLineThickness: Float = 3
     public var scatterPatternSize: Float = 10
+    /// When set, points are counted per pixel and drawn as a single density image,
+    /// instead of drawing a marker for each point. Defaults to `nil`.
+    public var densityRendering: DensityRendering? = nil
 
     public init(enableGrid: Bool = false){
         self.enableGrid = enableGrid
@@ -126,6 +129,7 @@ extension ScatterPlot: HasGraphLayout {
     
     public struct DrawingData {
         var series_scaledValues = [[Pair<T,U>]]()
+        var density: DensityGrid?
         var scaleX: Float = 1
         var scaleY: Float = 1
     }
@@ -136,29 +140,22 @@ extension ScatterPlot: HasGraphLayout {
         var results = DrawingData()
         var markers = PlotMarkers()
         
-        var maximumX: T = maxX(points: series[0].values)
-        var maximumY: U = maxY(points: series[0].values)
-        var minimumX: T = minX(points: series[0].values)
-        var minimumY: U = minY(points: series[0].values)
+        var (minimumX, maximumX, minimumY, maximumY) = boundsXY(points: series[0].values)
 
         for index in 1..<series.count {
 
-            let s: Series<T,U> = series[index]
-            var x: T = maxX(points: s.values)
-            var y: U = maxY(points: s.values)
-            if (x > maximumX) {
-                maximumX = x
+            let b = boundsXY(points: series[index].values)
+            if (b.maxX > maximumX) {
+                maximumX = b.maxX
             }
-            if (y > maximumY) {
-                maximumY = y
+            if (b.maxY > maximumY) {
+                maximumY = b.maxY
             }
-            x = minX(points: s.values)
-            y = minY(points: s.values)
-            if (x < minimumX) {
-                minimumX = x
+            if (b.minX < minimumX) {
+                minimumX = b.minX
             }
-            if (y < minimumY) {
-                minimumY = y
+            if (b.minY < minimumY) {
+                minimumY = b.minY
             }
         }
 
@@ -297,6 +294,14 @@ extension ScatterPlot: HasGraphLayout {
         // scale points to be plotted according to plot size
         let scaleXInv: Float = 1.0/results.scaleX;
         let scaleYInv: Float = 1.0/results.scaleY
+        if densityRendering != nil {
+            var density = DensityGrid(size: size)
+            for s in series {
+                density.add(s.values, scaleXInv: scaleXInv, scaleYInv: scaleYInv, origin: origin)
+            }
+            results.density = density
+            return (results, markers)
+        }
         results.series_scaledValues = series.map { series in
             series.values.compactMap { value in
                 let scaledPair = Pair<T,U>(value.x * T(scaleXInv) + T(origin.x),
@@ -314,11 +319,18 @@ extension ScatterPlot: HasGraphLayout {
 
     //functions to draw the plot
     public func drawData(_ data: DrawingData, size: Size, renderer: Renderer) {
+        if let density = data.density, let densityRendering = densityRendering {
+            renderer.drawImage(density.image(densityRendering),
+                               width: density.width,
+                               height: density.height,
+                               in: Rect(origin: .zero,
+                                        size: Size(width: Float(density.width), height: Float(density.height))))
+            return
+        }
         for seriesIndex in 0..<series.count {
             let s = series[seriesIndex]
             let scaledValues = data.series_scaledValues[seriesIndex]
-            let series_maxY = maxY(points: scaledValues)
-            let series_minY = minY(points: scaledValues)
+            let (series_minY, series_maxY) = boundsY(points: scaledValues)
             let seriesYRangeInverse: Float = 1.0/Float(series_maxY-series_minY)
 
             for value in scaledValues {
@@ -372,16 +384,7 @@ extension ScatterPlot: HasGraphLayout {
                     renderer.drawSolidPolygon(diamond,
                                               fillColor: color)
                 case .hexagon:
-                    var hexagonPoint = Point(p.x + 0.0,
-                                             p.y + scatterPatternSize*Float(0.5))
-                    var hexagonPoints: [Point] = [hexagonPoint]
-                    for _ in 2...6 {
-                        hexagonPoint = rotatePoint(point: hexagonPoint,
-                                                   center: p,
-                                                   angleDegrees: 60.0)
-                        hexagonPoints.append(hexagonPoint)
-                    }
-                    let hexagon = Polygon(hexagonPoints)!
+                    let hexagon = Polygon(hexagonPoints(center: p, radius: scatterPatternSize*Float(0.5)))!
                     renderer.drawSolidPolygon(hexagon,
                                               fillColor: color)
                 case .pentagon:
@@ -471,16 +474,7 @@ extension ScatterPlotSeriesOptions.ScatterPattern {
         case .hexagon:
             let c = Point((tL.x+bR.x)*Float(0.5),
                           (tL.y+bR.y)*Float(0.5))
-            var hexagonPoint = Point(c.x + 0.0,
-                                     c.y + (tL.y-bL.y)*Float(0.5))
-            var hexagonPoints: [Point] = [hexagonPoint]
-            for _ in 2...6 {
-                hexagonPoint = rotatePoint(point: hexagonPoint,
-                                           center: c,
-                                           angleDegrees: 60.0)
-                hexagonPoints.append(hexagonPoint)
-            }
-            let hexagon = Polygon(hexagonPoints)!
+            let hexagon = Polygon(hexagonPoints(center: c, radius: (tL.y-bL.y)*Float(0.5)))!
             renderer.drawSolidPolygon(hexagon,
                                       fillColor: color)
         case .pentagon:
@@ -524,3 +518,17 @@ extension ScatterPlotSeriesOptions.ScatterPattern {
         }
     }
 }
+
+/// The corners of a hexagon with one corner `radius` straight above `center`.
+func hexagonPoints(center: Point, radius: Float) -> [Point] {
+    var hexagonPoint = Point(center.x + 0.0,
+                             center.y + radius)
+    var hexagonPoints: [Point] = [hexagonPoint]
+    for _ in 2...6 {
+        hexagonPoint = rotatePoint(point: hexagonPoint,
+                                   center: center,
+                                   angleDegrees: 60.0)
+        hexagonPoints.append(hexagonPoint)
+    }
+    return hexagonPoints
+}
@@ -7,9 +7,11 @@ public struct Series<T,U> {
     public var color : Color = .blue
     public var startColor: Color? = nil
     public var endColor: Color? = nil
+    // The values of a series added to a LineGraph as an IndexedSeries, in place of `values`.
+    var indexedValues: IndexedSeries<T,U>? = nil
     public var count: Int {
         get {
-          return values.count
+          return indexedValues?.count ?? values.count
         }
     }
     public init() {}
@@ -0,0 +1,196 @@
+import Foundation
+
+/// A least-recently-used cache of text measurements for a single renderer.
+///
+/// Layout measures the same strings, such as axis marker labels, over and over again, both
+/// within a plot and across the subplots sharing a renderer. Measurements are keyed by the
+/// string, the text size and the renderer's `fontIdentifier`. Each renderer gets its own
+/// cache, which lives as long as the renderer does.
+public final class TextMeasurementCache {
+
+    public struct Statistics: Equatable {
+        public var hits = 0
+        public var misses = 0
+
+        public init(hits: Int = 0, misses: Int = 0) {
+            self.hits = hits
+            self.misses = misses
+        }
+
+        /// The fraction of lookups which were answered from the cache.
+        public var hitRate: Double {
+            let lookups = hits + misses
+            return lookups == 0 ? 0 : Double(hits) / Double(lookups)
+        }
+    }
+
+    public static let defaultCapacity = 1024
+
+    /// The maximum number of measurements kept.
+    public let capacity: Int
+
+    private struct Key: Hashable {
+        var text: String
+        var size: Float
+        var font: String
+    }
+
+    private struct Entry {
+        var key: Key
+        var size: Size
+        var newer: Int
+        var older: Int
+    }
+
+    // Entries form a doubly-linked list, by index, from the most to the least recently used.
+    private var indices: [Key: Int] = [:]
+    private var entries: [Entry] = []
+    private var newest = -1
+    private var oldest = -1
+    private var _statistics = Statistics()
+    private let lock = NSLock()
+
+    public init(capacity: Int = TextMeasurementCache.defaultCapacity) {
+        precondition(capacity > 0, "TextMeasurementCache: capacity must be positive.")
+        self.capacity = capacity
+    }
+
+    /// The number of hits and misses since the cache was created or last cleared.
+    public var statistics: Statistics {
+        lock.lock(); defer { lock.unlock() }
+        return _statistics
+    }
+
+    public var count: Int {
+        lock.lock(); defer { lock.unlock() }
+        return entries.count
+    }
+
+    /// Removes all measurements and resets the statistics.
+    public func removeAll() {
+        lock.lock(); defer { lock.unlock() }
+        indices.removeAll()
+        entries.removeAll()
+        newest = -1
+        oldest = -1
+        _statistics = Statistics()
+    }
+
+    /// Returns the size of `text` as laid out by `renderer`, measuring it only if it is not
+    /// already cached.
+    public func textLayoutSize(text: String, textSize: Float, renderer: Renderer) -> Size {
+        let key = Key(text: text, size: textSize, font: renderer.fontIdentifier)
+        lock.lock()
+        if let index = indices[key] {
+            _statistics.hits += 1
+            moveToNewest(index)
+            let size = entries[index].size
+            lock.unlock()
+            return size
+        }
+        _statistics.misses += 1
+        lock.unlock()
+
+        // Measure outside of the lock, as renderers may be slow to measure.
+        let size = renderer.getTextLayoutSize(text: text, textSize: textSize)
+
+        lock.lock()
+        insert(key, size)
+        lock.unlock()
+        return size
+    }
+
+    // MARK: List maintenance. The lock must be held.
+
+    private func insert(_ key: Key, _ size: Size) {
+        if let index = indices[key] {
+            // Measured concurrently by another thread.
+            entries[index].size = size
+            moveToNewest(index)
+            return
+        }
+        let index: Int
+        if entries.count < capacity {
+            index = entries.count
+            entries.append(Entry(key: key, size: size, newer: -1, older: -1))
+        } else {
+            // Reuse the least recently used entry.
+            index = oldest
+            unlink(index)
+            indices[entries[index].key] = nil
+            entries[index] = Entry(key: key, size: size, newer: -1, older: -1)
+        }
+        indices[key] = index
+        linkAsNewest(index)
+    }
+
+    private func moveToNewest(_ index: Int) {
+        guard index != newest else { return }
+        unlink(index)
+        linkAsNewest(index)
+    }
+
+    private func unlink(_ index: Int) {
+        let (newer, older) = (entries[index].newer, entries[index].older)
+        if newer >= 0 { entries[newer].older = older } else { newest = older }
+        if older >= 0 { entries[older].newer = newer } else { oldest = newer }
+    }
+
+    private func linkAsNewest(_ index: Int) {
+        entries[index].newer = -1
+        entries[index].older = newest
+        if newest >= 0 { entries[newest].newer = index }
+        newest = index
+        if oldest < 0 { oldest = index }
+    }
+}
+
+// MARK: - Per-renderer caches.
+
+extension TextMeasurementCache {
+
+    private final class Registration {
+        weak var renderer: Renderer?
+        let cache = TextMeasurementCache()
+
+        init(_ renderer: Renderer) {
+            self.renderer = renderer
+        }
+    }
+
+    private static var registrations: [ObjectIdentifier: Registration] = [:]
+    private static var nextPruneCount = 64
+    private static let registrationLock = NSLock()
+
+    /// Returns the cache belonging to `renderer`, creating it if needed.
+    public static func cache(for renderer: Renderer) -> TextMeasurementCache {
+        registrationLock.lock(); defer { registrationLock.unlock() }
+        let id = ObjectIdentifier(renderer)
+        // An identifier can be reused once its renderer has been deallocated,
+        // so check that the registration is still for this renderer.
+        if let registration = registrations[id], registration.renderer === renderer {
+            return registration.cache
+        }
+        if registrations.count >= nextPruneCount {
+            registrations = registrations.filter { $0.value.renderer != nil }
+            nextPruneCount = max(64, registrations.count * 2)
+        }
+        let registration = Registration(renderer)
+        registrations[id] = registration
+        return registration.cache
+    }
+}
+
+extension Renderer {
+
+    /// The cache used by layout to measure text with this renderer.
+    public var textMeasurementCache: TextMeasurementCache {
+        return TextMeasurementCache.cache(for: self)
+    }
+
+    /// Returns `getTextLayoutSize(text:textSize:)`, from this renderer's
+    /// `textMeasurementCache` if possible.
+    func getCachedTextLayoutSize(text: String, textSize size: Float) -> Size {
+        return textMeasurementCache.textLayoutSize(text: text, textSize: size, renderer: self)
+    }
+}
@@ -0,0 +1,47 @@
+#if canImport(AGGRenderer)
+import XCTest
+import Foundation
+import SwiftPlot
+import AGGRenderer
+
+extension AGGRendererTests {
+
+  /// Tests that charts rendered by reused worker renderers, at varying sizes, are the same
+  /// as charts rendered by fresh renderers.
+  func testBatchRendering() throws {
+    func makeChart(_ index: Int) -> Plot {
+      let x = (0..<50).map { Float($0) }
+      var lineGraph = LineGraph<Float,Float>(enablePrimaryAxisGrid: true)
+      lineGraph.addSeries(x, x.map { cos($0 / 5 + Float(index)) * 10 }, label: "Plot \(index)", color: .orange)
+      lineGraph.plotTitle = PlotTitle("BATCH \(index)")
+      return lineGraph
+    }
+    func size(_ index: Int) -> Size {
+      return Size(width: 300 + Float(index % 3) * 50, height: 200)
+    }
+
+    let outputURL = FileManager.default.temporaryDirectory
+      .appendingPathComponent("swiftplot_batch_\(ProcessInfo.processInfo.processIdentifier).png")
+    defer { try? FileManager.default.removeItem(at: outputURL) }
+
+    let chartCount = 20
+    let jobs = (0..<chartCount).map { index in
+      AGGBatchRenderer.Job(plot: makeChart(index), size: size(index),
+                           output: index == 7 ? .file(outputURL) : .memory)
+    }
+    let batchRenderer = AGGBatchRenderer(workerCount: 3)
+    let (results, report) = batchRenderer.render(jobs)
+    XCTAssertEqual(report.chartCount, chartCount)
+    XCTAssertEqual(report.failureCount, 0)
+    XCTAssertEqual(report.workerCount, 3)
+
+    for index in 0..<chartCount {
+      let renderer = AGGRenderer(width: size(index).width, height: size(index).height)
+      makeChart(index).drawGraph(size: size(index), renderer: renderer)
+      XCTAssertEqual(try results[index].get(), try renderer.pngData(), "Chart \(index) differs")
+    }
+    XCTAssertEqual(try Data(contentsOf: outputURL), try results[7].get())
+  }
+}
+
+#endif // canImport(AGGRenderer)
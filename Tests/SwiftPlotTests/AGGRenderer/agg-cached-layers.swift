@@ -0,0 +1,74 @@
+#if canImport(AGGRenderer)
+import XCTest
+import SwiftPlot
+import AGGRenderer
+
+extension AGGRendererTests {
+  
+  /// Tests that a graph drawn with new data over layers cached for the same axes and labels
+  /// looks the same as one whose layers are drawn, and that the layers are not used for
+  /// different axes.
+  func testCachedLayers() throws {
+    func graph(phase: Float, yRange: ClosedRange<Float> = -12...12) -> LineGraph<Float, Float> {
+      let x = (0..<100).map { Float($0) }
+      var lineGraph = LineGraph<Float, Float>(enablePrimaryAxisGrid: true)
+      lineGraph.addSeries(x, x.map { sin($0 / 8 + phase) * 10 }, label: "Plot 1", color: .orange)
+      lineGraph.plotTitle = PlotTitle("CACHED")
+      lineGraph.plotLabel = PlotLabel(xLabel: "X-AXIS", yLabel: "Y-AXIS")
+      lineGraph.visibleXRange = 0...100
+      lineGraph.visibleYRange = yRange
+      return lineGraph
+    }
+    let size = Size(width: 300, height: 200)
+    let renderer = AGGRenderer(width: size.width, height: size.height)
+    renderer.cachesLayers = true
+    graph(phase: 0).drawGraph(size: size, renderer: renderer)
+    renderer.imageSize = size
+    graph(phase: 1).drawGraph(size: size, renderer: renderer)
+    
+    let freshRenderer = AGGRenderer(width: size.width, height: size.height)
+    freshRenderer.cachesLayers = true
+    graph(phase: 1).drawGraph(size: size, renderer: freshRenderer)
+    XCTAssertEqual(try renderer.pngData(), try freshRenderer.pngData())
+    
+    renderer.imageSize = size
+    graph(phase: 1, yRange: -20...20).drawGraph(size: size, renderer: renderer)
+    // The fresh renderer draws the layers again, with none cached.
+    freshRenderer.imageSize = size
+    freshRenderer.cachesLayers = false
+    freshRenderer.cachesLayers = true
+    graph(phase: 1, yRange: -20...20).drawGraph(size: size, renderer: freshRenderer)
+    XCTAssertEqual(try renderer.pngData(), try freshRenderer.pngData())
+  }
+  
+  /// Tests that layers drawn while a clip rect is set are drawn within it, whether or not
+  /// they lie inside it, and that the clip rect still applies once they are drawn.
+  func testCachedLayersKeepClipRect() throws {
+    let clipRect = Rect(origin: Point(10, 10), size: Size(width: 40, height: 40))
+    let innerRect = Rect(origin: Point(20, 20), size: Size(width: 20, height: 20))
+    let renderer = AGGRenderer(width: 100, height: 100)
+    renderer.cachesLayers = true
+    for _ in 0..<2 {
+      renderer.imageSize = Size(width: 100, height: 100)
+      renderer.setClipRect(clipRect)
+      renderer.drawLayer(1, in: Rect(origin: .zero, size: Size(width: 100, height: 100)), isOpaque: true) {
+        $0.drawSolidRect(Rect(origin: .zero, size: Size(width: 100, height: 100)),
+                         fillColor: .black, hatchPattern: .none)
+      }
+      renderer.drawLayer(2, in: innerRect, isOpaque: true) {
+        $0.drawSolidRect(Rect(origin: .zero, size: Size(width: 100, height: 100)),
+                         fillColor: .green, hatchPattern: .none)
+      }
+      renderer.drawSolidRect(Rect(origin: Point(60, 60), size: Size(width: 30, height: 30)),
+                             fillColor: .red, hatchPattern: .none)
+      renderer.setClipRect(nil)
+      
+      let expectedRenderer = AGGRenderer(width: 100, height: 100)
+      expectedRenderer.drawSolidRect(clipRect, fillColor: .black, hatchPattern: .none)
+      expectedRenderer.drawSolidRect(innerRect, fillColor: .green, hatchPattern: .none)
+      XCTAssertEqual(try renderer.pngData(), try expectedRenderer.pngData())
+    }
+  }
+}
+
+#endif // canImport(AGGRenderer)
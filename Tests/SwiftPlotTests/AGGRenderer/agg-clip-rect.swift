@@ -0,0 +1,28 @@
+#if canImport(AGGRenderer)
+import XCTest
+import SwiftPlot
+import AGGRenderer
+
+extension AGGRendererTests {
+  
+  /// Tests that geometry drawn while a clip rect is set is only drawn inside it,
+  /// and that the clip rect is given in the current offset's coordinates.
+  func testClipRect() throws {
+    let renderer = AGGRenderer(width: 60, height: 40)
+    renderer.offset = Point(5, 5)
+    renderer.setClipRect(Rect(origin: Point(10, 5), size: Size(width: 30, height: 20)))
+    renderer.drawSolidRect(Rect(origin: Point(-5, -5), size: Size(width: 60, height: 40)),
+                           fillColor: .lightBlue, hatchPattern: .none)
+    let polyline = Polyline(Point(-500, -2), Point(-3, 0), Point(45, -400))!
+    renderer.drawPolyline(polyline, strokeWidth: 2, strokeColor: .black, isDashed: false)
+    renderer.setClipRect(nil)
+    renderer.offset = .zero
+    
+    let expectedRenderer = AGGRenderer(width: 60, height: 40)
+    expectedRenderer.drawSolidRect(Rect(origin: Point(15, 10), size: Size(width: 30, height: 20)),
+                                   fillColor: .lightBlue, hatchPattern: .none)
+    XCTAssertEqual(try renderer.pngData(), try expectedRenderer.pngData())
+  }
+}
+
+#endif // canImport(AGGRenderer)
@@ -0,0 +1,29 @@
+#if canImport(AGGRenderer)
+import XCTest
+import SwiftPlot
+import AGGRenderer
+
+extension AGGRendererTests {
+  
+  /// Tests that stacked rects filled in one pass have no seam along their shared edge.
+  /// Two rects of the same colour should look the same as one rect covering both;
+  /// filled one at a time, the background shows through the row they share.
+  func testCompoundFillsHaveNoSeams() throws {
+    let rects = [Rect(origin: Point(10, 5), size: Size(width: 20, height: 7.25)),
+                 Rect(origin: Point(10, 12.25), size: Size(width: 20, height: 10.75))]
+    let renderer = AGGRenderer(width: 40, height: 30)
+    renderer.usesCompoundFills = true
+    renderer.drawSolidRects(rects, fillColors: [.orange, .orange])
+    
+    let filledRenderer = AGGRenderer(width: 40, height: 30)
+    filledRenderer.drawSolidRect(Rect(origin: Point(10, 5), size: Size(width: 20, height: 18)),
+                                 fillColor: .orange, hatchPattern: .none)
+    XCTAssertEqual(try renderer.pngData(), try filledRenderer.pngData())
+    
+    let separateRenderer = AGGRenderer(width: 40, height: 30)
+    separateRenderer.drawSolidRects(rects, fillColors: [.orange, .orange])
+    XCTAssertNotEqual(try separateRenderer.pngData(), try filledRenderer.pngData())
+  }
+}
+
+#endif // canImport(AGGRenderer)
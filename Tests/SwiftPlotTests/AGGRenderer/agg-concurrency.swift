@@ -0,0 +1,42 @@
+#if canImport(AGGRenderer)
+import XCTest
+import Foundation
+import SwiftPlot
+import AGGRenderer
+
+extension AGGRendererTests {
+  
+  /// Tests that renderers on different threads are independent, by rendering 64 charts
+  /// concurrently and comparing them with the same charts rendered one at a time.
+  /// Run with `swift test --sanitize=thread` to check for data races.
+  func testConcurrentRendering() {
+    func render(_ index: Int) -> String {
+      let x = (0..<100).map { Float($0) }
+      let y = x.map { sin($0 / 10 + Float(index)) * 100 }
+      var lineGraph = LineGraph<Float,Float>(enablePrimaryAxisGrid: true)
+      lineGraph.addSeries(x, y, label: "Plot \(index)", color: .lightBlue)
+      lineGraph.plotTitle = PlotTitle("CHART \(index) Ω")
+      lineGraph.plotLabel = PlotLabel(xLabel: "X-AXIS", yLabel: "Y-AXIS")
+      let renderer = AGGRenderer(width: 400 + Float(index % 4) * 10, height: 300)
+      lineGraph.drawGraph(size: renderer.imageSize, renderer: renderer)
+      return renderer.base64Png()
+    }
+    
+    let chartCount = 64
+    let expected = (0..<chartCount).map(render)
+    var results = [String](repeating: "", count: chartCount)
+    let lock = NSLock()
+    DispatchQueue.concurrentPerform(iterations: chartCount) { index in
+      let output = render(index)
+      lock.lock()
+      results[index] = output
+      lock.unlock()
+    }
+    for index in 0..<chartCount {
+      XCTAssertFalse(results[index].isEmpty)
+      XCTAssertEqual(results[index], expected[index], "Chart \(index) differs when rendered concurrently")
+    }
+  }
+}
+
+#endif // canImport(AGGRenderer)
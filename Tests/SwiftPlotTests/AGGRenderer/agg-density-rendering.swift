@@ -0,0 +1,34 @@
+#if canImport(AGGRenderer)
+import XCTest
+import SwiftPlot
+import AGGRenderer
+
+extension AGGRendererTests {
+  
+  /// Tests that a scatter plot in density mode is drawn as an image instead of markers,
+  /// and that the normalization changes the shading.
+  func testDensityRendering() throws {
+    let count = 300_000
+    let x = (0..<count).map { i in Float(i % 1000) * 0.01 + sin(Float(i)) }
+    let y = (0..<count).map { i in cos(Float(i) * 0.37) * Float(i % 97) * 0.1 }
+    let size = Size(width: 300, height: 200)
+    
+    func render(_ plot: ScatterPlot<Float, Float>) throws -> Data {
+      let renderer = AGGRenderer(width: size.width, height: size.height)
+      plot.drawGraph(size: size, renderer: renderer)
+      return try renderer.pngData()
+    }
+    
+    var scatterPlot = ScatterPlot<Float,Float>(enableGrid: true)
+    scatterPlot.addSeries(x, y, label: "Plot 1", color: .green)
+    var densityPlot = scatterPlot
+    densityPlot.densityRendering = DensityRendering(colorMap: .viridis, normalization: .histogramEqualization)
+    XCTAssertNotEqual(try render(densityPlot), try render(scatterPlot))
+    
+    var linearPlot = densityPlot
+    linearPlot.densityRendering?.normalization = .linear
+    XCTAssertNotEqual(try render(linearPlot), try render(densityPlot))
+  }
+}
+
+#endif // canImport(AGGRenderer)
@@ -0,0 +1,40 @@
+#if canImport(AGGRenderer)
+import XCTest
+import SwiftPlot
+import AGGRenderer
+
+extension AGGRendererTests {
+  
+  /// Tests that a polyline whose outline needs more cells than the rasterizer can hold at
+  /// once is still drawn in full. The zig-zag covers the whole image, so it should look the
+  /// same as a filled rectangle; previously, only its left part was drawn.
+  func testLongPolylineIsDrawnCompletely() throws {
+    let pointCount = 50_000
+    let points = (0..<pointCount).map { i in
+      Point(-10 + 220 * Float(i) / Float(pointCount - 1), i % 2 == 0 ? -10 : 110)
+    }
+    guard let polyline = Polyline(points) else {
+      XCTFail("Failed to create polyline")
+      return
+    }
+    let renderer = AGGRenderer(width: 200, height: 100)
+    renderer.drawPolyline(polyline, strokeWidth: 2, strokeColor: .black, isDashed: false)
+    
+    let filledRenderer = AGGRenderer(width: 200, height: 100)
+    filledRenderer.drawSolidRect(Rect(origin: Point(-1, -1), size: Size(width: 202, height: 102)),
+                                 fillColor: .black, hatchPattern: .none)
+    XCTAssertEqual(try renderer.pngData(), try filledRenderer.pngData())
+  }
+  
+  /// Tests that a polyline of zero width draws nothing when hairlines are disabled, as they
+  /// are by default.
+  func testZeroWidthPolylineIsNotDrawn() throws {
+    let renderer = AGGRenderer(width: 100, height: 100)
+    let blankPNG = try renderer.pngData()
+    let polyline = Polyline(Point(10, 10), Point(50, 80), Point(90, 20))!
+    renderer.drawPolyline(polyline, strokeWidth: 0, strokeColor: .black, isDashed: false)
+    XCTAssertEqual(try renderer.pngData(), blankPNG)
+  }
+}
+
+#endif // canImport(AGGRenderer)
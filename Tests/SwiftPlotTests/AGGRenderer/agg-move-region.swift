@@ -0,0 +1,36 @@
+#if canImport(AGGRenderer)
+import XCTest
+import SwiftPlot
+import AGGRenderer
+
+extension AGGRendererTests {
+  
+  /// Tests that moving a region by whole pixels looks the same as drawing its contents
+  /// there, and leaves the rest of the image alone.
+  func testMoveRegion() throws {
+    func drawShapes(_ renderer: AGGRenderer, at offset: Point) {
+      renderer.drawSolidCircle(center: Point(22.5, 14.25) + offset, radius: 6.3, fillColor: .orange)
+      renderer.drawLine(startPoint: Point(12, 3) + offset, endPoint: Point(31.5, 24) + offset,
+                        strokeWidth: 1.5, strokeColor: .blue, isDashed: false)
+    }
+    let renderer = AGGRenderer(width: 50, height: 30)
+    XCTAssertTrue(renderer.supportsIncrementalUpdates)
+    drawShapes(renderer, at: .zero)
+    renderer.drawSolidRect(Rect(origin: Point(42, 0), size: Size(width: 8, height: 30)),
+                           fillColor: .green, hatchPattern: .none)
+    renderer.moveRegion(Rect(origin: Point(6, 0), size: Size(width: 34, height: 30)), by: Point(-5, 2))
+    // The part of the region which nothing was moved into still holds what was drawn there.
+    renderer.drawSolidRect(Rect(origin: Point(35, 0), size: Size(width: 5, height: 30)),
+                           fillColor: .white, hatchPattern: .none)
+    renderer.drawSolidRect(Rect(origin: Point(6, 0), size: Size(width: 34, height: 2)),
+                           fillColor: .white, hatchPattern: .none)
+    
+    let movedRenderer = AGGRenderer(width: 50, height: 30)
+    drawShapes(movedRenderer, at: Point(-5, 2))
+    movedRenderer.drawSolidRect(Rect(origin: Point(42, 0), size: Size(width: 8, height: 30)),
+                                fillColor: .green, hatchPattern: .none)
+    XCTAssertEqual(try renderer.pngData(), try movedRenderer.pngData())
+  }
+}
+
+#endif // canImport(AGGRenderer)
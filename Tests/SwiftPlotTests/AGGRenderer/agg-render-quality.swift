@@ -0,0 +1,50 @@
+#if canImport(AGGRenderer)
+import XCTest
+import SwiftPlot
+import AGGRenderer
+
+extension AGGRendererTests {
+  
+  /// Tests that a chart drawn in draft quality differs from one drawn in normal quality,
+  /// and that a renderer switched back from draft draws exactly like a fresh renderer.
+  func testRenderQuality() throws {
+    let x = (0..<50).map { Float($0) }
+    var scatterPlot = ScatterPlot<Float,Float>(enableGrid: true)
+    scatterPlot.addSeries(x, x.map { sin($0 / 5) * 10 }, label: "Plot 1", color: .green, scatterPattern: .circle)
+    scatterPlot.plotTitle = PlotTitle("DRAFT")
+    let size = Size(width: 300, height: 200)
+    
+    let normalRenderer = AGGRenderer(width: size.width, height: size.height)
+    scatterPlot.drawGraph(size: size, renderer: normalRenderer)
+    
+    let renderer = AGGRenderer(width: size.width, height: size.height)
+    renderer.renderQuality = .draft
+    scatterPlot.drawGraph(size: size, renderer: renderer)
+    XCTAssertNotEqual(try renderer.pngData(), try normalRenderer.pngData())
+    
+    renderer.renderQuality = .normal
+    renderer.imageSize = size
+    scatterPlot.drawGraph(size: size, renderer: renderer)
+    XCTAssertEqual(try renderer.pngData(), try normalRenderer.pngData())
+  }
+  
+  /// Tests that rects and horizontal lines with fractional edges are aliased in draft quality:
+  /// each pixel is filled if at least half of it is covered, and left alone otherwise.
+  func testDraftQualityIsAliased() throws {
+    let renderer = AGGRenderer(width: 200, height: 200)
+    renderer.renderQuality = .draft
+    renderer.drawSolidRect(Rect(origin: Point(20.2, 20.2), size: Size(width: 100.6, height: 60.6)),
+                           fillColor: .black, hatchPattern: .none)
+    renderer.drawLine(startPoint: Point(10, 150.3), endPoint: Point(190, 150.3),
+                      strokeWidth: 1, strokeColor: .black, isDashed: false)
+    
+    let expectedRenderer = AGGRenderer(width: 200, height: 200)
+    expectedRenderer.drawSolidRect(Rect(origin: Point(20, 20), size: Size(width: 101, height: 61)),
+                                   fillColor: .black, hatchPattern: .none)
+    expectedRenderer.drawSolidRect(Rect(origin: Point(10, 150), size: Size(width: 180, height: 1)),
+                                   fillColor: .black, hatchPattern: .none)
+    XCTAssertEqual(try renderer.pngData(), try expectedRenderer.pngData())
+  }
+}
+
+#endif // canImport(AGGRenderer)
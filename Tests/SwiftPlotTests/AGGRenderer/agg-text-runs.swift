@@ -0,0 +1,26 @@
+#if canImport(AGGRenderer)
+import XCTest
+import SwiftPlot
+import AGGRenderer
+
+extension AGGRendererTests {
+  
+  /// Tests that text is measured as UTF-8, so that non-ASCII characters get the
+  /// advances of their own glyphs rather than one per byte.
+  func testTextMeasurementUTF8() {
+    let renderer = AGGRenderer()
+    let label = renderer.getTextLayoutSize(text: "x-axis 0.25", textSize: 10)
+    XCTAssertEqual(label.width, 47.609375)
+    XCTAssertEqual(label.height, 9)
+    XCTAssertEqual(renderer.getTextLayoutSize(text: "é", textSize: 14).width,
+                   renderer.getTextLayoutSize(text: "e", textSize: 14).width)
+    XCTAssertEqual(renderer.getTextLayoutSize(text: "Ωμέγα", textSize: 12).width, 34.046875)
+    
+    // Measuring, then drawing, then measuring again reuses the same text run.
+    renderer.drawText(text: "Ωμέγα", location: Point(10, 10), textSize: 12,
+                      color: .black, strokeWidth: 1.2, angle: 90)
+    XCTAssertEqual(renderer.getTextLayoutSize(text: "Ωμέγα", textSize: 12).width, 34.046875)
+  }
+}
+
+#endif // canImport(AGGRenderer)
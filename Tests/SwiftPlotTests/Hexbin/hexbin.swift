@@ -0,0 +1,32 @@
+import XCTest
+@testable import SwiftPlot
+import SVGRenderer
+
+final class HexbinTests: SwiftPlotTestCase {
+
+    /// Tests that every point is counted exactly once, in the hexagon whose centre is
+    /// nearest to it, and across enough points to be counted concurrently.
+    func testHexbinCounts() throws {
+        let count = 300_000
+        let points = (0..<count).map { i in
+            Pair<Float,Float>(sin(Float(i) * 0.013) * Float(i % 101), cos(Float(i) * 0.029) * Float(i % 89))
+        }
+        var hexbin = HexbinPlot(points: points, hexagonRadius: 7.5)
+        hexbin.normalization = .logarithmic
+        let size = Size(width: 400, height: 300)
+        let (data, markers) = hexbin.layoutData(size: size, renderer: SVGRenderer())
+        let grid = try XCTUnwrap(data.grid)
+        XCTAssertEqual(grid.counts.reduce(0) { $0 + Int($1) }, count)
+        XCTAssertFalse(try XCTUnwrap(markers).xMarkers.isEmpty)
+
+        let transform = LineGraph<Float,Float>.AxisLayoutInfo(series: [Series(values: points, label: "")],
+                                                               size: size).transform
+        for point in points.prefix(1000) {
+            let position = transform.apply(point)
+            let cell = try XCTUnwrap(grid.cell(position.x, position.y))
+            let center = grid.center(ofCell: cell)
+            // Within the hexagon, so no further from its centre than its corners.
+            XCTAssertLessThanOrEqual(hypot(position.x - center.x, position.y - center.y), grid.radius * 1.0001)
+        }
+    }
+}
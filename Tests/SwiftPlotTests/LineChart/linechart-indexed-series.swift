@@ -0,0 +1,89 @@
+import XCTest
+@testable import SwiftPlot
+import SVGRenderer
+
+extension LineChartTests {
+
+  // Sorted by x, with repeated x values, and with y values which are all distinct.
+  private static let indexedPoints = (0..<200_003).map { i in
+    Pair<Double, Double>(Double(i / 3) * 0.5, sin(Double(i) * 0.37) * Double(i % 997 + 1) + Double(i) * 1e-7)
+  }
+
+  func testLineChartIndexedSeries() throws {
+    let points = LineChartTests.indexedPoints
+    let series = IndexedSeries(values: points)
+    XCTAssertEqual(series.count, points.count)
+
+    let all = boundsXY(points: points)
+    let bounds = try XCTUnwrap(series.bounds())
+    XCTAssertEqual(bounds.x, all.minX...all.maxX)
+    XCTAssertEqual(bounds.y, all.minY...all.maxY)
+    let xRange = 1234.25...31337.0
+    let inRange = boundsXY(points: points.filter { xRange.contains($0.x) })
+    let rangeBounds = try XCTUnwrap(series.bounds(in: xRange))
+    XCTAssertEqual(rangeBounds.x, inRange.minX...inRange.maxX)
+    XCTAssertEqual(rangeBounds.y, inRange.minY...inRange.maxY)
+    XCTAssertNil(series.bounds(in: -2 ... -1))
+
+    // Each column keeps its first, last, lowest and highest points, and only the
+    // neighbouring points are kept from outside the range.
+    let columns = 37
+    let decimated = series.decimated(in: xRange, columns: columns)
+    XCTAssertLessThanOrEqual(decimated.count, 4 * columns + 2)
+    XCTAssertEqual(decimated.first, points.last { $0.x < xRange.lowerBound })
+    XCTAssertEqual(decimated.last, points.first { $0.x > xRange.upperBound })
+    let columnWidth = (xRange.upperBound - xRange.lowerBound) / Double(columns)
+    for column in 0..<columns {
+      let isInColumn = { (point: Pair<Double, Double>) -> Bool in
+        xRange.contains(point.x)
+          && (column == 0 || point.x >= xRange.lowerBound + Double(column) * columnWidth)
+          && (column == columns - 1 || point.x < xRange.lowerBound + Double(column + 1) * columnWidth)
+      }
+      let expected = points.filter(isInColumn)
+      let actual = decimated.filter(isInColumn)
+      XCTAssertEqual(actual.first, expected.first)
+      XCTAssertEqual(actual.last, expected.last)
+      XCTAssertEqual(actual.map { $0.y }.min(), expected.map { $0.y }.min())
+      XCTAssertEqual(actual.map { $0.y }.max(), expected.map { $0.y }.max())
+    }
+  }
+
+  func testLineChartIndexedSeriesFile() throws {
+    let url = FileManager.default.temporaryDirectory
+      .appendingPathComponent("swiftplot-\(UUID().uuidString).index")
+    defer { try? FileManager.default.removeItem(at: url) }
+    let series = IndexedSeries(values: LineChartTests.indexedPoints)
+    try series.write(to: url)
+
+    let mapped = try IndexedSeries<Double, Double>(contentsOf: url)
+    XCTAssertEqual(mapped.count, series.count)
+    XCTAssertTrue((0..<series.count).allSatisfy { mapped[$0] == series[$0] })
+    XCTAssertEqual(mapped.decimated(columns: 100), series.decimated(columns: 100))
+    XCTAssertThrowsError(try IndexedSeries<Float, Float>(contentsOf: url))
+  }
+
+  func testLineChartIndexedSeriesLayout() throws {
+    let points = LineChartTests.indexedPoints
+    var plain = LineGraph<Double, Double>()
+    plain.addSeries(points: points, label: "Plain")
+    var indexed = LineGraph<Double, Double>()
+    indexed.addSeries(IndexedSeries(values: points), label: "Indexed")
+
+    let size = Size(width: 400, height: 300)
+    for xRange in [nil, 1234.25...31337.0] as [ClosedRange<Double>?] {
+      plain.visibleXRange = xRange
+      indexed.visibleXRange = xRange
+      let plainInfo = try XCTUnwrap(plain.layoutData(size: size, renderer: SVGRenderer()).0.primaryAxisInfo)
+      let indexedInfo = try XCTUnwrap(indexed.layoutData(size: size, renderer: SVGRenderer()).0.primaryAxisInfo)
+      XCTAssertEqual(indexedInfo.bounds.x, plainInfo.bounds.x)
+      XCTAssertEqual(indexedInfo.bounds.y, plainInfo.bounds.y)
+    }
+
+    // Only the decimated points are drawn.
+    let plainRenderer = SVGRenderer()
+    plain.drawGraph(size: size, renderer: plainRenderer)
+    let indexedRenderer = SVGRenderer()
+    indexed.drawGraph(size: size, renderer: indexedRenderer)
+    XCTAssertLessThan(indexedRenderer.svg.count, plainRenderer.svg.count / 10)
+  }
+}
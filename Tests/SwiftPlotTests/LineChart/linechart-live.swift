@@ -0,0 +1,80 @@
+#if canImport(AGGRenderer)
+import XCTest
+import SwiftPlot
+import AGGRenderer
+
+extension LineChartTests {
+
+  private static func livePoint(_ i: Int) -> Pair<Float, Float> {
+    return Pair(Float(i) * 0.5, 40 * sin(Float(i) * 0.21) + 10 * cos(Float(i) * 1.7))
+  }
+
+  private static func liveGraph(mode: LiveLineGraph<Float, Float>.UpdateMode) -> LiveLineGraph<Float, Float> {
+    var style = LineGraph<Float, Float>(enablePrimaryAxisGrid: true)
+    style.plotTitle = PlotTitle("LIVE")
+    let live = LiveLineGraph<Float, Float>(windowWidth: 100, mode: mode, graph: style)
+    live.yRange = -60...60
+    live.addSeries(capacity: 400, label: "Sensor", color: .orange)
+    return live
+  }
+
+  func testLineChartLiveRingBuffer() {
+    var ring = RingBufferSeries<Float, Float>(capacity: 4)
+    ring.append(contentsOf: (0..<3).map(LineChartTests.livePoint))
+    XCTAssertEqual(Array(ring), (0..<3).map(LineChartTests.livePoint))
+    ring.append(contentsOf: (3..<10).map(LineChartTests.livePoint))
+    XCTAssertEqual(Array(ring), (6..<10).map(LineChartTests.livePoint))
+    XCTAssertEqual(ring.count, 4)
+    XCTAssertEqual(ring.appendedCount, 10)
+  }
+
+  /// Tests that a graph drawn a few points at a time in sweep mode looks the same as one
+  /// drawn in full, and that it is only drawn in full when the x axis moves on.
+  func testLineChartLiveSweep() throws {
+    let size = Size(width: 400, height: 300)
+    let live = LineChartTests.liveGraph(mode: .sweep)
+    let renderer = AGGRenderer(width: size.width, height: size.height)
+    live.append(contentsOf: (0..<40).map(LineChartTests.livePoint), toSeries: 0)
+    XCTAssertEqual(live.draw(size: size, renderer: renderer), .full)
+    XCTAssertEqual(live.draw(size: size, renderer: renderer), .unchanged)
+    // The first window ends at x = 75.
+    for start in stride(from: 40, to: 150, by: 7) {
+      live.append(contentsOf: (start..<min(start + 7, 150)).map(LineChartTests.livePoint), toSeries: 0)
+      XCTAssertEqual(live.draw(size: size, renderer: renderer), .partial)
+    }
+
+    let fullLive = LineChartTests.liveGraph(mode: .sweep)
+    let fullRenderer = AGGRenderer(width: size.width, height: size.height)
+    fullLive.append(contentsOf: (0..<150).map(LineChartTests.livePoint), toSeries: 0)
+    XCTAssertEqual(fullLive.draw(size: size, renderer: fullRenderer), .full)
+    XCTAssertEqual(try renderer.pngData(), try fullRenderer.pngData())
+
+    live.append(LineChartTests.livePoint(151), toSeries: 0)
+    XCTAssertEqual(live.draw(size: size, renderer: renderer), .full)
+    live.append(LineChartTests.livePoint(152), toSeries: 0)
+    XCTAssertEqual(live.draw(size: size, renderer: AGGRenderer(width: size.width, height: size.height)), .full)
+  }
+
+  /// Tests that a graph in scroll mode is scrolled rather than drawn in full, until it has
+  /// scrolled by the width of the plot.
+  func testLineChartLiveScroll() {
+    let size = Size(width: 400, height: 300)
+    let live = LineChartTests.liveGraph(mode: .scroll)
+    let renderer = AGGRenderer(width: size.width, height: size.height)
+    live.append(contentsOf: (0..<40).map(LineChartTests.livePoint), toSeries: 0)
+    XCTAssertEqual(live.draw(size: size, renderer: renderer), .full)
+    var updates = [LiveLineGraph<Float, Float>.Update]()
+    for i in 40..<400 {
+      live.append(LineChartTests.livePoint(i), toSeries: 0)
+      updates.append(live.draw(size: size, renderer: renderer))
+    }
+    XCTAssertTrue(updates.contains(.scrolled))
+    XCTAssertFalse(updates.contains(.unchanged))
+    // The window is 200 points wide, so the plot scrolls by its width at least once.
+    let fullDraws = updates.filter { $0 == .full }.count
+    XCTAssertGreaterThan(fullDraws, 0)
+    XCTAssertLessThan(fullDraws, 20)
+  }
+}
+
+#endif // canImport(AGGRenderer)
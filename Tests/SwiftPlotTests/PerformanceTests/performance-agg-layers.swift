@@ -0,0 +1,29 @@
+#if canImport(AGGRenderer)
+import XCTest
+import SwiftPlot
+import AGGRenderer
+
+extension PerformanceTests {
+    
+    /// Performance test for redrawing a line graph with new data 20 times, with its axes,
+    /// grid and labels copied from `AGGRenderer`'s cached layers.
+    func testPerformanceAGGCachedLayers() {
+        let renderer = AGGRenderer()
+        renderer.cachesLayers = true
+        let x = (0..<1000).map { Float($0) }
+        measure {
+            for phase in 0..<20 {
+                var lineGraph = LineGraph<Float, Float>(enablePrimaryAxisGrid: true)
+                lineGraph.addSeries(x, x.map { sin($0 / 40 + Float(phase)) * 10 }, label: "Plot 1", color: .orange)
+                lineGraph.plotTitle = PlotTitle("DASHBOARD")
+                lineGraph.plotLabel = PlotLabel(xLabel: "X-AXIS", yLabel: "Y-AXIS")
+                lineGraph.visibleXRange = 0...1000
+                lineGraph.visibleYRange = -12...12
+                renderer.imageSize = renderer.imageSize
+                lineGraph.drawGraph(size: renderer.imageSize, renderer: renderer)
+            }
+        }
+    }
+}
+
+#endif // canImport(AGGRenderer)
@@ -0,0 +1,38 @@
+#if canImport(AGGRenderer)
+import XCTest
+import SwiftPlot
+import AGGRenderer
+
+extension PerformanceTests {
+    
+    /// Performance test for stroking a 1M-segment line series, 10M segments per measurement.
+    func testPerformanceAGGLineSeries() {
+        let renderer = AGGRenderer()
+        let polyline = aggBenchmarkLineSeries
+        measure {
+            renderer.drawPolyline(polyline, strokeWidth: 1.5, strokeColor: .blue, isDashed: false)
+        }
+    }
+    
+    /// Performance test for drawing the same series as hairlines.
+    func testPerformanceAGGLineSeriesHairline() {
+        let renderer = AGGRenderer()
+        renderer.hairlineWidth = 1.5
+        let polyline = aggBenchmarkLineSeries
+        measure {
+            renderer.drawPolyline(polyline, strokeWidth: 1.5, strokeColor: .blue, isDashed: false)
+        }
+    }
+}
+
+/// A dense, smooth series of 1M segments across the default image size.
+private let aggBenchmarkLineSeries: Polyline = {
+    let count = 1_000_001
+    let points = (0..<count).map { i -> Point in
+        let t = Float(i) / Float(count)
+        return Point(10 + 980 * t, 330 + 250 * sin(t * 20) + 5 * sin(Float(i) * 0.001))
+    }
+    return Polyline(points)!
+}()
+
+#endif // canImport(AGGRenderer)
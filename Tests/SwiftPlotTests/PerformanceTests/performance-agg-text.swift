@@ -0,0 +1,36 @@
+#if canImport(AGGRenderer)
+import XCTest
+import SwiftPlot
+import AGGRenderer
+
+extension PerformanceTests {
+    
+    /// Performance test for drawing 10k tick labels with `AGGRenderer`'s default text path.
+    func testPerformanceAGGTickLabels() {
+        let renderer = AGGRenderer()
+        measure {
+            drawAGGBenchmarkTickLabels(renderer)
+        }
+    }
+    
+    /// Performance test for drawing 10k tick labels from `AGGRenderer`'s glyph atlas.
+    func testPerformanceAGGTickLabelsGlyphAtlas() {
+        let renderer = AGGRenderer()
+        renderer.usesGlyphAtlas = true
+        measure {
+            drawAGGBenchmarkTickLabels(renderer)
+        }
+    }
+}
+
+/// Draws a frame of 10k tick labels, from a set of 200 distinct strings.
+private func drawAGGBenchmarkTickLabels(_ renderer: AGGRenderer) {
+    let labels = (0..<200).map { "\(Float($0) * 0.25 - 10)" }
+    for i in 0..<10_000 {
+        let location = Point(10 + Float(i % 20) * 49.3, 10 + Float(i / 20 % 60) * 10.7)
+        renderer.drawText(text: labels[i % labels.count], location: location, textSize: 10,
+                          color: .black, strokeWidth: 1.2, angle: 0)
+    }
+}
+
+#endif // canImport(AGGRenderer)
@@ -0,0 +1,25 @@
+import XCTest
+@testable import SwiftPlot
+
+extension PerformanceTests {
+
+    /// Performance tests for the fused, single-pass `boundsXY(points:)` used by chart layout.
+    func testPerformanceSeriesBounds() throws {
+        // Long enough to be split into concurrent chunks, with a tail which is not a
+        // whole number of SIMD vectors.
+        let points = (0..<1_000_003).map { i in
+            Pair<Float, Float>(Float(i % 7919) - 3000, sin(Float(i) * 0.001) * Float(i % 101))
+        }
+        let b = boundsXY(points: points)
+        XCTAssertEqual(b.minX, minX(points: points))
+        XCTAssertEqual(b.maxX, maxX(points: points))
+        XCTAssertEqual(b.minY, minY(points: points))
+        XCTAssertEqual(b.maxY, maxY(points: points))
+        let y = boundsY(points: points)
+        XCTAssertEqual(y.minY, b.minY)
+        XCTAssertEqual(y.maxY, b.maxY)
+        measure {
+            _ = boundsXY(points: points)
+        }
+    }
+}
@@ -0,0 +1,34 @@
+import XCTest
+@testable import SwiftPlot
+
+extension PerformanceTests {
+
+    /// Performance tests for transforming a whole series at once with `CoordinateTransform`.
+    func testPerformanceCoordinateTransform() throws {
+        let floatPoints = (0..<1_000_003).map { i in
+            Pair<Float, Float>(Float(i) * 0.01 - 300, sin(Float(i) * 0.001) * 50)
+        }
+        let doublePoints = floatPoints.map { Pair<Double, Double>(Double($0.x), Double($0.y)) }
+        let floatTransform = CoordinateTransform(originValue: Pair<Float, Float>(-300, -50), origin: Point(40, 25),
+                                                 scaleX: 17.3, scaleY: 0.21)
+        let doubleTransform = CoordinateTransform(originValue: Pair<Double, Double>(-300, -50), origin: Point(40, 25),
+                                                  scaleX: 17.3, scaleY: 0.21)
+        let offset = Point(12.5, 7.25)
+
+        // The bulk transform must match transforming each value, including the tail which
+        // is not a whole number of SIMD vectors.
+        let floatColumns = floatTransform.apply(floatPoints, offset: offset)
+        let doubleColumns = doubleTransform.apply(doublePoints, offset: offset)
+        for index in stride(from: 0, to: floatPoints.count, by: 997) + [floatPoints.count - 1] {
+            let floatPoint = floatTransform.apply(floatPoints[index])
+            XCTAssertEqual(floatColumns.xs[index], floatPoint.x + offset.x)
+            XCTAssertEqual(floatColumns.ys[index], floatPoint.y + offset.y)
+            let doublePoint = doubleTransform.apply(doublePoints[index])
+            XCTAssertEqual(doubleColumns.xs[index], doublePoint.x + offset.x)
+            XCTAssertEqual(doubleColumns.ys[index], doublePoint.y + offset.y)
+        }
+        measure {
+            _ = floatTransform.apply(floatPoints, offset: offset)
+        }
+    }
+}
@@ -0,0 +1,23 @@
+import XCTest
+@testable import SwiftPlot
+
+extension PerformanceTests {
+
+    /// Performance tests for decimating a zoomed window of a long `IndexedSeries`, which
+    /// should not depend on the number of points in the window.
+    func testPerformanceIndexedSeriesDecimation() throws {
+        let points = (0..<4_000_000).map { i in
+            Pair<Float, Float>(Float(i) * 0.25, sin(Float(i) * 0.001) * Float(i % 101))
+        }
+        let series = IndexedSeries(values: points)
+        let xRange: ClosedRange<Float> = 100_000...900_000
+        let decimated = series.decimated(in: xRange, columns: 1000)
+        XCTAssertLessThanOrEqual(decimated.count, 4 * 1000 + 2)
+        let bounds = try XCTUnwrap(series.bounds(in: xRange))
+        XCTAssertEqual(bounds.y.lowerBound, decimated.dropFirst().dropLast().map { $0.y }.min())
+        XCTAssertEqual(bounds.y.upperBound, decimated.dropFirst().dropLast().map { $0.y }.max())
+        measure {
+            _ = series.decimated(in: xRange, columns: 1000)
+        }
+    }
+}
@@ -0,0 +1,37 @@
+import XCTest
+import SwiftPlot
+import SVGRenderer
+
+extension PerformanceTests {
+    
+    /// Performance test for writing a 100k-point polyline with `SVGRenderer`'s default,
+    /// shortest round-trip number formatting.
+    func testPerformanceSVGPolylineShortest() {
+        let polyline = makeSVGBenchmarkPolyline(count: 100_000)
+        measure {
+            let renderer = SVGRenderer()
+            renderer.drawPolyline(polyline, strokeWidth: 1.5, strokeColor: .lightBlue, isDashed: false)
+        }
+    }
+    
+    /// Performance test for writing a 100k-point polyline with `SVGRenderer`'s fixed-precision
+    /// number formatting and hex colours, streamed into a byte buffer, which should also be
+    /// smaller than the default output.
+    func testPerformanceSVGPolylineFixedPrecision() {
+        let polyline = makeSVGBenchmarkPolyline(count: 100_000)
+        let defaultRenderer = SVGRenderer()
+        defaultRenderer.drawPolyline(polyline, strokeWidth: 1.5, strokeColor: .lightBlue, isDashed: false)
+        let defaultSize = defaultRenderer.svg.utf8.count
+        var size = 0
+        measure {
+            let buffer = SVGByteBuffer(minimumCapacity: 2_000_000)
+            let renderer = SVGRenderer(streamingTo: buffer)
+            renderer.coordinatePrecision = 1
+            renderer.colorFormat = .hex
+            renderer.drawPolyline(polyline, strokeWidth: 1.5, strokeColor: .lightBlue, isDashed: false)
+            renderer.finishStreaming()
+            size = buffer.count
+        }
+        XCTAssertLessThan(size, defaultSize, "Expected fewer bytes than the default output")
+    }
+}
@@ -0,0 +1,44 @@
+import XCTest
+import SwiftPlot
+import SVGRenderer
+
+extension SVGRendererTests {
+
+  /// Tests that elements drawn while a clip rect is set are written into a clipped group,
+  /// that elements entirely outside the clip rect are left out, and that solid polylines
+  /// are split into their visible runs while dashed ones are kept whole.
+  func testClipRect() {
+    let clipRect = Rect(origin: Point(10, 10), size: Size(width: 50, height: 40))
+    let points = [Point(0, 20), Point(30, 20), Point(30, 500), Point(500, 500),
+                  Point(500, 30), Point(40, 30), Point(40, 15)]
+
+    let renderer = SVGRenderer(width: 100, height: 100)
+    renderer.setClipRect(clipRect)
+    renderer.drawSolidRect(Rect(origin: Point(50, 40), size: Size(width: 30, height: 30)),
+                           fillColor: .black, hatchPattern: .none)
+    renderer.drawSolidRect(Rect(origin: Point(70, 70), size: Size(width: 10, height: 10)),
+                           fillColor: .black, hatchPattern: .none)
+    renderer.drawPolyline(Polyline(points)!, strokeWidth: 1, strokeColor: .black, isDashed: false)
+    renderer.setClipRect(nil)
+    renderer.drawSolidRect(Rect(origin: Point(70, 70), size: Size(width: 10, height: 10)),
+                           fillColor: .black, hatchPattern: .none)
+    let svg = renderer.svg
+    XCTAssertTrue(svg.contains(#"<defs><clipPath id="clip0"><rect x="10" y="50" width="50" height="40"/></clipPath></defs><g clip-path="url(#clip0)">"#))
+    XCTAssertEqual(svg.components(separatedBy: "<g clip-path=").count, svg.components(separatedBy: "</g>").count)
+    XCTAssertEqual(svg.components(separatedBy: #"style="fill:"#).count - 1, 2)
+    XCTAssertTrue(svg.contains(#"<polyline points="0,80 30,80 30,-400""#))
+    XCTAssertTrue(svg.contains(#"<polyline points="500,70 40,70 40,85""#))
+    XCTAssertEqual(svg.components(separatedBy: "<polyline").count - 1, 2)
+
+    let dashedRenderer = SVGRenderer(width: 100, height: 100)
+    dashedRenderer.setClipRect(clipRect)
+    dashedRenderer.drawPolyline(Polyline(points)!, strokeWidth: 1, strokeColor: .black, isDashed: true)
+    dashedRenderer.drawPolyline(Polyline(Point(200, 200), Point(300, 300))!,
+                                strokeWidth: 1, strokeColor: .black, isDashed: true)
+    let dashedSVG = dashedRenderer.svg
+    XCTAssertTrue(dashedSVG.contains(#"<polyline points="0,80 30,80 30,-400 500,-400 500,70 40,70 40,85""#))
+    XCTAssertEqual(dashedSVG.components(separatedBy: "<polyline").count - 1, 1)
+    // The clip group is closed when the document is finished.
+    XCTAssertTrue(dashedSVG.hasSuffix("\n</g>\n</svg>"))
+  }
+}
@@ -0,0 +1,53 @@
+import XCTest
+import SwiftPlot
+import SVGRenderer
+
+extension SVGRendererTests {
+  
+  /// Tests that the compact encoding shares marker definitions and styles, and is
+  /// several times smaller than the standard encoding for a large scatter plot.
+  func testCompactEncodingScatterPlot() {
+    var generator = SystemRandomNumberGenerator()
+    let x = (0..<5000).map { _ in Float.random(in: 0...1000, using: &generator) }
+    let y = (0..<5000).map { _ in Float.random(in: 0...1000, using: &generator) }
+    var scatterPlot = ScatterPlot<Float,Float>(enableGrid: true)
+    scatterPlot.addSeries(x, y, label: "Plot 1", color: .gold, scatterPattern: .circle)
+    scatterPlot.addSeries(y, x, label: "Plot 2", color: .green, scatterPattern: .star)
+    
+    let standardRenderer = SVGRenderer()
+    scatterPlot.drawGraph(renderer: standardRenderer)
+    let compactRenderer = SVGRenderer()
+    compactRenderer.compactEncoding = true
+    compactRenderer.coordinatePrecision = 1
+    scatterPlot.drawGraph(renderer: compactRenderer)
+    
+    let compact = compactRenderer.svg
+    XCTAssertTrue(compact.contains(#"<defs><circle id="m0" r="#))
+    XCTAssertTrue(compact.contains(##"<use xlink:href="#m0" x=""##))
+    XCTAssertTrue(compact.contains(#"<defs><path id="m1" d="M0 0l"#))
+    XCTAssertEqual(compact.components(separatedBy: "<g class=").count,
+                   compact.components(separatedBy: "</g>").count)
+    XCTAssertLessThan(compact.utf8.count * 3, standardRenderer.svg.utf8.count,
+                      "Expected the compact encoding to be at least 3x smaller")
+  }
+  
+  /// Tests that compact polylines are written as delta-encoded paths and that the
+  /// quantized deltas do not accumulate rounding error.
+  func testCompactEncodingPolyline() {
+    let renderer = SVGRenderer(width: 100, height: 100)
+    renderer.compactEncoding = true
+    renderer.coordinatePrecision = 1
+    let polyline = Polyline(Point(0.04, 0), Point(0.08, 0), Point(0.12, 0), Point(10, 50), Point(10, 50))!
+    renderer.drawPolyline(polyline, strokeWidth: 2, strokeColor: .black, isDashed: true)
+    renderer.drawLine(startPoint: Point(1, 1), endPoint: Point(2, 2),
+                      strokeWidth: 2, strokeColor: .black, isDashed: true)
+    let expected = """
+      <style>.s0{fill:none;stroke:rgb(0,0,0);stroke-width:2;stroke-dasharray:4 1}</style>
+      <g class="s0">
+      <path d="M0 100l0.1 0 9.9-50"/>
+      <path d="M1 99L2 98"/>
+      </g>
+      """
+    XCTAssertTrue(renderer.svg.contains(expected), renderer.svg)
+  }
+}
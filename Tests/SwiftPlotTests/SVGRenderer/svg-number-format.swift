@@ -0,0 +1,61 @@
+import XCTest
+import SwiftPlot
+import SVGRenderer
+
+extension SVGRendererTests {
+  
+  /// Tests that coordinates are rounded to `coordinatePrecision` while opacities and
+  /// stroke widths keep their precision.
+  func testCoordinatePrecision() {
+    let expected = [
+      #"<line x1="12" y1="88" x2="-3" y2="1" style="stroke:rgb(255,127.5,0);stroke-width:0.125;opacity:0.25;stroke-linecap:butt" />"#,
+      #"<line x1="12.3" y1="87.7" x2="-3" y2="0.5" style="stroke:rgb(255,127.5,0);stroke-width:0.125;opacity:0.25;stroke-linecap:butt" />"#,
+      #"<line x1="12.35" y1="87.65" x2="-3" y2="0.5" style="stroke:rgb(255,127.5,0);stroke-width:0.125;opacity:0.25;stroke-linecap:butt" />"#,
+      #"<line x1="12.346" y1="87.654" x2="-3" y2="0.5" style="stroke:rgb(255,127.5,0);stroke-width:0.125;opacity:0.25;stroke-linecap:butt" />"#,
+    ]
+    for (precision, line) in expected.enumerated() {
+      let renderer = SVGRenderer(width: 100, height: 100)
+      renderer.coordinatePrecision = precision
+      renderer.drawLine(startPoint: Point(12.3456, 12.3456), endPoint: Point(-3, 99.5),
+                        strokeWidth: 0.125, strokeColor: Color(1, 0.5, 0, 0.25), isDashed: false)
+      XCTAssertTrue(renderer.svg.contains(line), "precision \(precision): \(renderer.svg)")
+    }
+  }
+  
+  /// Tests that colours can be written as `#rrggbb`.
+  func testHexColorFormat() {
+    let renderer = SVGRenderer(width: 100, height: 100)
+    renderer.colorFormat = .hex
+    renderer.drawSolidCircle(center: Point(50, 50), radius: 10, fillColor: .lightBlue)
+    XCTAssertTrue(renderer.svg.contains(#"style="fill:#87ceeb;opacity:1.0""#), renderer.svg)
+  }
+  
+  /// Tests that fixed precision shrinks a large polyline.
+  func testFixedPrecisionOutputSize() {
+    let polyline = makeSVGBenchmarkPolyline(count: 10_000)
+    
+    let shortestRenderer = SVGRenderer()
+    shortestRenderer.drawPolyline(polyline, strokeWidth: 1.5, strokeColor: .lightBlue, isDashed: false)
+    let shortestSize = shortestRenderer.svg.utf8.count
+    
+    let fixedRenderer = SVGRenderer()
+    fixedRenderer.coordinatePrecision = 1
+    fixedRenderer.colorFormat = .hex
+    fixedRenderer.drawPolyline(polyline, strokeWidth: 1.5, strokeColor: .lightBlue, isDashed: false)
+    let fixedSize = fixedRenderer.svg.utf8.count
+    
+    XCTAssertLessThan(fixedSize * 3, shortestSize * 2,
+                      "Expected at least a third fewer bytes: \(fixedSize) vs \(shortestSize)")
+  }
+}
+
+/// A noisy sine wave which exercises the number formatter with many significant digits.
+func makeSVGBenchmarkPolyline(count: Int) -> Polyline {
+  var generator = SystemRandomNumberGenerator()
+  let points = (0..<count).map { i -> Point in
+    let x = Float(i) * 990 / Float(count) + 5
+    let y = 330 + 300 * sin(Float(i) / 100) + Float.random(in: -5...5, using: &generator)
+    return Point(x, y)
+  }
+  return Polyline(points)!
+}
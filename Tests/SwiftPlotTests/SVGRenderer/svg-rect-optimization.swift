@@ -0,0 +1,42 @@
+import XCTest
+import SwiftPlot
+import SVGRenderer
+
+extension SVGRendererTests {
+  
+  /// Tests that adjacent rects of the same colour are merged, and that merged rects are
+  /// written before the next element.
+  func testMergeAdjacentRects() {
+    let renderer = SVGRenderer(width: 100, height: 100)
+    renderer.mergesAdjacentRects = true
+    for column in 0..<10 {
+      let rect = Rect(origin: Point(Float(column), 0), size: Size(width: 1, height: 1))
+      renderer.drawSolidRect(rect, fillColor: column < 5 ? .red : .blue, hatchPattern: .none)
+    }
+    renderer.drawLine(startPoint: Point(0, 0), endPoint: Point(10, 0),
+                      strokeWidth: 1, strokeColor: .black, isDashed: false)
+    let lines = renderer.svg.split(separator: "\n")
+    XCTAssertEqual(lines.filter { $0.hasPrefix("<rect x=") }.count, 2)
+    XCTAssertTrue(lines[3].hasPrefix(#"<rect x="0.0" y="99.0" width="5.0" height="1.0" style="fill:rgb(255.0,0.0,0.0)"#), String(lines[3]))
+    XCTAssertTrue(lines[4].hasPrefix(#"<rect x="5.0" y="99.0" width="5.0" height="1.0" style="fill:rgb(0.0,0.0,255.0)"#), String(lines[4]))
+    XCTAssertTrue(lines[5].hasPrefix("<line "))
+  }
+  
+  /// Tests that a large heatmap is written as an embedded PNG rather than a rect per cell.
+  func testRectGridImage() {
+    let values = (0..<200).map { row in (0..<200).map { column in Float((row / 10 + column / 10) % 7) } }
+    let heatmap = values.plots.heatmap()
+    
+    let standardRenderer = SVGRenderer()
+    heatmap.drawGraph(renderer: standardRenderer)
+    let imageRenderer = SVGRenderer()
+    imageRenderer.rectGridImageThreshold = 1000
+    heatmap.drawGraph(renderer: imageRenderer)
+    
+    let svg = imageRenderer.svg
+    XCTAssertEqual(svg.components(separatedBy: "<image ").count, 2)
+    // "iVBORw0KGgo" is the base64-encoded PNG signature.
+    XCTAssertTrue(svg.contains("data:image/png;base64,iVBORw0KGgo"))
+    XCTAssertLessThan(svg.utf8.count * 10, standardRenderer.svg.utf8.count)
+  }
+}
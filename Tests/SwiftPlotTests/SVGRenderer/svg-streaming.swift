@@ -0,0 +1,50 @@
+import XCTest
+import SwiftPlot
+import SVGRenderer
+
+extension SVGRendererTests {
+  
+  /// Tests that a document streamed through a small buffer contains the same elements
+  /// as the same graph rendered in-memory.
+  func testStreamingOutput() {
+    let x:[Float] = [10,100,263,489]
+    let y:[Float] = [10,120,500,800]
+    var lineGraph = LineGraph<Float,Float>(enablePrimaryAxisGrid: true)
+    lineGraph.addSeries(x, y, label: "Plot 1", color: .lightBlue)
+    lineGraph.plotTitle = PlotTitle("SINGLE SERIES")
+    lineGraph.plotLabel = PlotLabel(xLabel: "X-AXIS", yLabel: "Y-AXIS")
+    
+    let inMemoryRenderer = SVGRenderer()
+    lineGraph.drawGraph(renderer: inMemoryRenderer)
+    
+    let buffer = SVGByteBuffer()
+    let streamingRenderer = SVGRenderer(streamingTo: buffer, bufferCapacity: 256)
+    lineGraph.drawGraph(renderer: streamingRenderer)
+    XCTAssertTrue(streamingRenderer.isStreaming)
+    XCTAssertTrue(streamingRenderer.svg.isEmpty)
+    streamingRenderer.finishStreaming()
+    
+    let streamed = buffer.string
+    XCTAssertTrue(streamed.hasPrefix(#"<svg height="660" width="1000" version="4.0""#))
+    XCTAssertTrue(streamed.hasSuffix("\n</svg>"))
+    XCTAssertEqual(streamed.split(separator: "\n").count,
+                   inMemoryRenderer.svg.split(separator: "\n").count)
+    
+    // Finishing again must not append a second footer.
+    let finishedCount = buffer.count
+    streamingRenderer.finishStreaming()
+    XCTAssertEqual(buffer.count, finishedCount)
+  }
+  
+  /// Tests the fixed-precision number formatting used when streaming.
+  func testStreamingNumberFormatting() {
+    let buffer = SVGByteBuffer()
+    let renderer = SVGRenderer(streamingTo: buffer, width: 100, height: 100)
+    renderer.drawLine(startPoint: Point(1.5, 10), endPoint: Point(2.0004, 99.75),
+                      strokeWidth: 0.25, strokeColor: .black, isDashed: false)
+    renderer.finishStreaming()
+    XCTAssertTrue(buffer.string.contains(
+      #"<line x1="1.5" y1="90" x2="2" y2="0.25" style="stroke:rgb(0,0,0);stroke-width:0.25;opacity:1;stroke-linecap:butt" />"#
+    ))
+  }
+}
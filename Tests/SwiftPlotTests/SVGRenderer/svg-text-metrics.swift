@@ -0,0 +1,39 @@
+import XCTest
+import SwiftPlot
+import SVGRenderer
+
+extension SVGRendererTests {
+  
+  /// Tests that the bundled font measures text exactly as AGGRenderer does.
+  func testTrueTypeTextMetrics() throws {
+    let metrics = try XCTUnwrap(TrueTypeFontMetrics.bundledFont)
+    XCTAssertEqual(metrics.unitsPerEm, 2048)
+    
+    let hello = metrics.measure("Hello, World! AVWa 123", size: 14)
+    XCTAssertEqual(hello.width, 147.015625)
+    XCTAssertEqual(hello.height, 13)
+    let label = metrics.measure("x-axis 0.25", size: 10)
+    XCTAssertEqual(label.width, 47.609375)
+    XCTAssertEqual(label.height, 9)
+    // Non-ASCII characters have their own advances.
+    XCTAssertEqual(metrics.measure("é", size: 14).width, metrics.measure("e", size: 14).width)
+    XCTAssertEqual(metrics.measure("Ωμέγα", size: 12).width, 34.046875)
+    // Measurements are cached; a second call must give the same result.
+    XCTAssertEqual(metrics.measure("x-axis 0.25", size: 10).width, label.width)
+    // Roboto only has GPOS kerning, so enabling kerning changes nothing.
+    let unkerned = metrics.measure("AVWa", size: 14)
+    metrics.usesKerning = true
+    defer { metrics.usesKerning = false }
+    XCTAssertEqual(metrics.measure("AVWa", size: 14).width, unkerned.width)
+    
+    let renderer = SVGRenderer()
+    renderer.textMetrics = metrics
+    XCTAssertEqual(renderer.getTextLayoutSize(text: "x-axis 0.25", textSize: 10).width, 47.609375)
+  }
+  
+  /// Tests that invalid font data is rejected rather than crashing.
+  func testTrueTypeTextMetricsInvalidFont() {
+    XCTAssertThrowsError(try TrueTypeFontMetrics(data: Data()))
+    XCTAssertThrowsError(try TrueTypeFontMetrics(data: Data(repeating: 0xFF, count: 64)))
+  }
+}
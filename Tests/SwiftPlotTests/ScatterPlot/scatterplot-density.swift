@@ -0,0 +1,32 @@
+import XCTest
+@testable import SwiftPlot
+
+extension ScatterPlotTests {
+  
+  /// Tests that points are counted into the cells of a `DensityGrid` the same way whether
+  /// a series is counted concurrently in chunks or in smaller series one at a time, and
+  /// that each normalization spans the color map.
+  func testScatterPlotDensityGrid() throws {
+    let count = 300_000
+    let points = (0..<count).map { i in
+      Pair<Float,Float>(Float(i % 1000) * 0.3 + sin(Float(i)), cos(Float(i) * 0.37) * Float(i % 97) + 100)
+    }
+    let size = Size(width: 300, height: 200)
+    var grid = DensityGrid(size: size)
+    grid.add(points, scaleXInv: 1, scaleYInv: 1, origin: .zero)
+    var halves = DensityGrid(size: size)
+    halves.add(Array(points[..<(count / 2)]), scaleXInv: 1, scaleYInv: 1, origin: .zero)
+    halves.add(Array(points[(count / 2)...]), scaleXInv: 1, scaleYInv: 1, origin: .zero)
+    XCTAssertEqual(grid.counts, halves.counts)
+    
+    let inside = points.filter { $0.x >= 0 && $0.x <= size.width && $0.y >= 0 && $0.y <= size.height }
+    XCTAssertEqual(grid.counts.reduce(0) { $0 + Int($1) }, inside.count)
+    
+    for normalization in [DensityRendering.Normalization.linear, .logarithmic, .histogramEqualization] {
+      let offsets = grid.offsets(normalization).compactMap { $0 }
+      XCTAssertEqual(offsets.count, grid.counts.filter { $0 > 0 }.count)
+      XCTAssertEqual(offsets.max(), 1)
+    }
+    XCTAssertEqual(grid.offsets(.histogramEqualization).compactMap { $0 }.min(), 0)
+  }
+}
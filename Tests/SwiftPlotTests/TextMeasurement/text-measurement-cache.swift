@@ -0,0 +1,58 @@
+import XCTest
+import SwiftPlot
+import SVGRenderer
+
+extension TextMeasurementTests {
+  
+  /// Tests that repeated layout with the same renderer is answered from its cache.
+  func testTextMeasurementCacheHits() {
+    var lineGraph = LineGraph<Float,Float>(enablePrimaryAxisGrid: true)
+    lineGraph.addSeries([10,100,263,489], [10,120,500,800], label: "Plot 1", color: .lightBlue)
+    lineGraph.plotLabel = PlotLabel(xLabel: "X-AXIS", yLabel: "Y-AXIS")
+    
+    let renderer = SVGRenderer()
+    let cache = renderer.textMeasurementCache
+    XCTAssertTrue(cache === TextMeasurementCache.cache(for: renderer))
+    XCTAssertFalse(cache === SVGRenderer().textMeasurementCache)
+    
+    lineGraph.drawGraph(renderer: renderer)
+    let firstPass = cache.statistics
+    XCTAssertGreaterThan(firstPass.misses, 0)
+    let expectedSVG = renderer.svg
+    
+    let secondRenderer = SVGRenderer()
+    lineGraph.drawGraph(renderer: secondRenderer)
+    XCTAssertEqual(cache.statistics, firstPass)
+    XCTAssertEqual(secondRenderer.svg, expectedSVG)
+    
+    renderer.textMeasurementCache.removeAll()
+    lineGraph.drawGraph(renderer: renderer)
+    lineGraph.drawGraph(renderer: renderer)
+    let stats = cache.statistics
+    XCTAssertEqual(stats.misses, firstPass.misses)
+    XCTAssertGreaterThanOrEqual(stats.hits, firstPass.hits + firstPass.misses)
+    XCTAssertGreaterThan(stats.hitRate, 0.5)
+  }
+  
+  /// Tests that the least recently used measurements are evicted first, and that
+  /// measurements with different fonts are kept apart.
+  func testTextMeasurementCacheEviction() throws {
+    let renderer = SVGRenderer()
+    let cache = TextMeasurementCache(capacity: 2)
+    _ = cache.textLayoutSize(text: "a", textSize: 10, renderer: renderer)
+    _ = cache.textLayoutSize(text: "b", textSize: 10, renderer: renderer)
+    _ = cache.textLayoutSize(text: "a", textSize: 10, renderer: renderer)
+    _ = cache.textLayoutSize(text: "c", textSize: 10, renderer: renderer) // Evicts "b".
+    XCTAssertEqual(cache.count, 2)
+    XCTAssertEqual(cache.statistics, TextMeasurementCache.Statistics(hits: 1, misses: 3))
+    _ = cache.textLayoutSize(text: "a", textSize: 10, renderer: renderer)
+    _ = cache.textLayoutSize(text: "b", textSize: 10, renderer: renderer)
+    XCTAssertEqual(cache.statistics, TextMeasurementCache.Statistics(hits: 2, misses: 4))
+    
+    // Changing the font must not return the old measurement.
+    let estimated = cache.textLayoutSize(text: "b", textSize: 10, renderer: renderer)
+    renderer.textMetrics = try XCTUnwrap(TrueTypeFontMetrics.bundledFont)
+    let measured = cache.textLayoutSize(text: "b", textSize: 10, renderer: renderer)
+    XCTAssertNotEqual(estimated, measured)
+  }
+}
@@ -0,0 +1,3 @@
+import XCTest
+
+final class TextMeasurementTests: SwiftPlotTestCase {}
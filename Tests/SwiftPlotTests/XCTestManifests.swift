@@ -7,6 +7,19 @@ extension AGGRendererTests {
     // to regenerate.
     static let __allTests__AGGRendererTests = [
         ("testBase64Encoding", testBase64Encoding),
+        ("testBatchRendering", testBatchRendering),
+        ("testCachedLayers", testCachedLayers),
+        ("testCachedLayersKeepClipRect", testCachedLayersKeepClipRect),
+        ("testClipRect", testClipRect),
+        ("testCompoundFillsHaveNoSeams", testCompoundFillsHaveNoSeams),
+        ("testConcurrentRendering", testConcurrentRendering),
+        ("testDensityRendering", testDensityRendering),
+        ("testDraftQualityIsAliased", testDraftQualityIsAliased),
+        ("testLongPolylineIsDrawnCompletely", testLongPolylineIsDrawnCompletely),
+        ("testMoveRegion", testMoveRegion),
+        ("testRenderQuality", testRenderQuality),
+        ("testTextMeasurementUTF8", testTextMeasurementUTF8),
+        ("testZeroWidthPolylineIsNotDrawn", testZeroWidthPolylineIsNotDrawn),
     ]
 }
 
@@ -55,6 +68,15 @@ extension HeatmapTests {
     ]
 }
 
+extension HexbinTests {
+    // DO NOT MODIFY: This is autogenerated, use:
+    //   `swift test --generate-linuxmain`
+    // to regenerate.
+    static let __allTests__HexbinTests = [
+        ("testHexbinCounts", testHexbinCounts),
+    ]
+}
+
 extension HistogramTests {
     // DO NOT MODIFY: This is autogenerated, use:
     //   `swift test --generate-linuxmain`
@@ -88,6 +110,12 @@ extension LineChartTests {
         ("testLineChart_positiveYOrigin", testLineChart_positiveYOrigin),
         ("testLineChart_smallXRange", testLineChart_smallXRange),
         ("testLineChartFunctionPlot", testLineChartFunctionPlot),
+        ("testLineChartIndexedSeries", testLineChartIndexedSeries),
+        ("testLineChartIndexedSeriesFile", testLineChartIndexedSeriesFile),
+        ("testLineChartIndexedSeriesLayout", testLineChartIndexedSeriesLayout),
+        ("testLineChartLiveRingBuffer", testLineChartLiveRingBuffer),
+        ("testLineChartLiveScroll", testLineChartLiveScroll),
+        ("testLineChartLiveSweep", testLineChartLiveSweep),
         ("testLineChartMultipleSeries", testLineChartMultipleSeries),
         ("testLineChartSecondaryAxis", testLineChartSecondaryAxis),
         ("testLineChartSingleSeries", testLineChartSingleSeries),
@@ -102,7 +130,37 @@ extension PerformanceTests {
     //   `swift test --generate-linuxmain`
     // to regenerate.
     static let __allTests__PerformanceTests = [
+        ("testPerformanceAGGCachedLayers", testPerformanceAGGCachedLayers),
+        ("testPerformanceAGGLineSeries", testPerformanceAGGLineSeries),
+        ("testPerformanceAGGLineSeriesHairline", testPerformanceAGGLineSeriesHairline),
+        ("testPerformanceAGGTickLabels", testPerformanceAGGTickLabels),
+        ("testPerformanceAGGTickLabelsGlyphAtlas", testPerformanceAGGTickLabelsGlyphAtlas),
+        ("testPerformanceCoordinateTransform", testPerformanceCoordinateTransform),
         ("testPerformanceHistogramRecalculateBins", testPerformanceHistogramRecalculateBins),
+        ("testPerformanceIndexedSeriesDecimation", testPerformanceIndexedSeriesDecimation),
+        ("testPerformanceSVGPolylineFixedPrecision", testPerformanceSVGPolylineFixedPrecision),
+        ("testPerformanceSVGPolylineShortest", testPerformanceSVGPolylineShortest),
+        ("testPerformanceSeriesBounds", testPerformanceSeriesBounds),
+    ]
+}
+
+extension SVGRendererTests {
+    // DO NOT MODIFY: This is autogenerated, use:
+    //   `swift test --generate-linuxmain`
+    // to regenerate.
+    static let __allTests__SVGRendererTests = [
+        ("testClipRect", testClipRect),
+        ("testCompactEncodingPolyline", testCompactEncodingPolyline),
+        ("testCompactEncodingScatterPlot", testCompactEncodingScatterPlot),
+        ("testCoordinatePrecision", testCoordinatePrecision),
+        ("testFixedPrecisionOutputSize", testFixedPrecisionOutputSize),
+        ("testHexColorFormat", testHexColorFormat),
+        ("testMergeAdjacentRects", testMergeAdjacentRects),
+        ("testRectGridImage", testRectGridImage),
+        ("testStreamingNumberFormatting", testStreamingNumberFormatting),
+        ("testStreamingOutput", testStreamingOutput),
+        ("testTrueTypeTextMetrics", testTrueTypeTextMetrics),
+        ("testTrueTypeTextMetricsInvalidFont", testTrueTypeTextMetricsInvalidFont),
     ]
 }
 
@@ -112,6 +170,7 @@ extension ScatterPlotTests {
     // to regenerate.
     static let __allTests__ScatterPlotTests = [
         ("testScatterPlot", testScatterPlot),
+        ("testScatterPlotDensityGrid", testScatterPlotDensityGrid),
     ]
 }
 
@@ -124,17 +183,30 @@ extension SubPlotTests {
     ]
 }
 
+extension TextMeasurementTests {
+    // DO NOT MODIFY: This is autogenerated, use:
+    //   `swift test --generate-linuxmain`
+    // to regenerate.
+    static let __allTests__TextMeasurementTests = [
+        ("testTextMeasurementCacheEviction", testTextMeasurementCacheEviction),
+        ("testTextMeasurementCacheHits", testTextMeasurementCacheHits),
+    ]
+}
+
 public func __allTests() -> [XCTestCaseEntry] {
     return [
         testCase(AGGRendererTests.__allTests__AGGRendererTests),
         testCase(AnnotationTests.__allTests__AnnotationTests),
         testCase(BarchartTests.__allTests__BarchartTests),
         testCase(HeatmapTests.__allTests__HeatmapTests),
+        testCase(HexbinTests.__allTests__HexbinTests),
         testCase(HistogramTests.__allTests__HistogramTests),
         testCase(LineChartTests.__allTests__LineChartTests),
         testCase(PerformanceTests.__allTests__PerformanceTests),
+        testCase(SVGRendererTests.__allTests__SVGRendererTests),
         testCase(ScatterPlotTests.__allTests__ScatterPlotTests),
         testCase(SubPlotTests.__allTests__SubPlotTests),
+        testCase(TextMeasurementTests.__allTests__TextMeasurementTests),
     ]
 }
 #endif